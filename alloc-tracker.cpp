@@ -0,0 +1,136 @@
+#include "alloc-tracker.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace countdown {
+
+namespace {
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> bytes{0};
+    std::atomic<std::uint64_t> live{0};
+    std::atomic<std::uint64_t> peak{0};
+    // live bytes at the last reset
+    std::atomic<std::uint64_t> base{0};
+    std::atomic<bool> counting{true};
+
+    // keeps the memory after it aligned like malloc's
+    constexpr std::size_t headerSize = alignof(std::max_align_t);
+
+    void *allocate(std::size_t const size) noexcept
+    {
+        auto *const block = static_cast<char*>(std::malloc(headerSize + size));
+        if (not block) return nullptr;
+        // a size of 0 marks memory that is not counted
+        if (not counting.load(std::memory_order_relaxed)) {
+            *reinterpret_cast<std::size_t*>(block) = 0;
+            return block + headerSize;
+        }
+        *reinterpret_cast<std::size_t*>(block) = size;
+
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        bytes.fetch_add(size, std::memory_order_relaxed);
+        auto const now = live.fetch_add(size, std::memory_order_relaxed) + size;
+        auto high = peak.load(std::memory_order_relaxed);
+        while (now > high
+               and not peak.compare_exchange_weak(high, now, std::memory_order_relaxed)) { }
+
+        return block + headerSize;
+    }
+
+    void deallocate(void *const ptr) noexcept
+    {
+        if (not ptr) return;
+        auto *const block = static_cast<char*>(ptr) - headerSize;
+        if (auto const size = *reinterpret_cast<std::size_t*>(block); size != 0) {
+            live.fetch_sub(size, std::memory_order_relaxed);
+        }
+        std::free(block);
+    }
+
+    void *allocateOrThrow(std::size_t const size)
+    {
+        // malloc(0) may return null, new must not
+        if (auto *const ptr = allocate(size == 0 ? 1 : size)) return ptr;
+        throw std::bad_alloc{};
+    }
+}
+
+void resetAllocStats() noexcept
+{
+    auto const now = live.load(std::memory_order_relaxed);
+    allocations = 0;
+    bytes = 0;
+    base = now;
+    peak = now;
+}
+
+AllocStats allocStats() noexcept
+{
+    return {allocations.load(), bytes.load(), peak.load() - base.load()};
+}
+
+void countAllocations(bool const on) noexcept
+{
+    counting.store(on, std::memory_order_relaxed);
+}
+
+void print(std::ostream &os, AllocStats const &stats)
+{
+    os << stats.allocations << " (" << stats.bytes << " bytes, peak "
+       << stats.peak << " bytes live)";
+}
+
+}  // namespace countdown
+
+void *operator new(std::size_t const size)
+{
+    return countdown::allocateOrThrow(size);
+}
+
+void *operator new[](std::size_t const size)
+{
+    return countdown::allocateOrThrow(size);
+}
+
+void *operator new(std::size_t const size, std::nothrow_t const &) noexcept
+{
+    return countdown::allocate(size == 0 ? 1 : size);
+}
+
+void *operator new[](std::size_t const size, std::nothrow_t const &) noexcept
+{
+    return countdown::allocate(size == 0 ? 1 : size);
+}
+
+void operator delete(void *const ptr) noexcept
+{
+    countdown::deallocate(ptr);
+}
+
+void operator delete[](void *const ptr) noexcept
+{
+    countdown::deallocate(ptr);
+}
+
+void operator delete(void *const ptr, std::size_t) noexcept
+{
+    countdown::deallocate(ptr);
+}
+
+void operator delete[](void *const ptr, std::size_t) noexcept
+{
+    countdown::deallocate(ptr);
+}
+
+void operator delete(void *const ptr, std::nothrow_t const &) noexcept
+{
+    countdown::deallocate(ptr);
+}
+
+void operator delete[](void *const ptr, std::nothrow_t const &) noexcept
+{
+    countdown::deallocate(ptr);
+}
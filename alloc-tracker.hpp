@@ -0,0 +1,53 @@
+/*
+ * Count heap allocations of a whole program.
+ *
+ * alloc-tracker.cpp replaces the global operator new and delete, so only programs that
+ * compile it in are counted, the library itself is not affected.
+ * Every allocation carries a small header with its size, so live bytes can be tracked
+ * on delete. Over-aligned allocations keep the default operators and are not counted.
+ * Counting can be switched off for code that is timed, then new and delete only add
+ * the header to malloc and free and touch no counters.
+ */
+
+#ifndef COUNTDOWN_ALLOC_TRACKER_HPP
+#define COUNTDOWN_ALLOC_TRACKER_HPP
+
+#include <cstdint>
+#include <ostream>
+
+namespace countdown {
+
+// Programs that count optionally are built with COUNTDOWN_TRACK_ALLOCATIONS when they
+// compile in alloc-tracker.cpp and only call the functions below if this is set.
+#ifdef COUNTDOWN_TRACK_ALLOCATIONS
+inline constexpr bool trackAllocations = true;
+#else
+inline constexpr bool trackAllocations = false;
+#endif
+
+struct AllocStats
+{
+    // number of calls to operator new
+    std::uint64_t allocations = 0;
+    // bytes requested by them
+    std::uint64_t bytes = 0;
+    // largest number of bytes live at the same time, counted from the last reset
+    std::uint64_t peak = 0;
+};
+
+// Start counting from zero, bytes that are live now do not count towards the peak.
+void resetAllocStats() noexcept;
+
+// everything since the last reset
+AllocStats allocStats() noexcept;
+
+// Count from now on or not, on by default. Memory allocated while counting is off is
+// never counted, not even when it is deleted.
+void countAllocations(bool on) noexcept;
+
+// the counts on one line
+void print(std::ostream &os, AllocStats const &stats);
+
+}  // namespace countdown
+
+#endif  // COUNTDOWN_ALLOC_TRACKER_HPP
@@ -0,0 +1,198 @@
+#include "best-first.hpp"
+#include "combine.hpp"
+#include "subset-dp.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <queue>
+
+namespace countdown {
+
+namespace {
+    enum class Op : char { val, sum, sub, mul, div };
+
+    // An expression, its operands are expressions that were taken from the queue before.
+    struct Expression
+    {
+        int value;
+        // the sum of the costs of all operations in the expression
+        int cost;
+        Op op;
+        std::uint32_t a, b;
+        // index of the multiset of numbers it uses
+        std::uint32_t multiset;
+    };
+
+    struct Later
+    {
+        bool operator()(Expression const &l, Expression const &r) const
+        {
+            return l.cost > r.cost;
+        }
+    };
+
+    int digits(int value)
+    {
+        int n = 1;
+        while (value >= 10) {
+            value /= 10;
+            ++n;
+        }
+        return n;
+    }
+
+    std::string str(std::vector<Expression> const &done, std::uint32_t const index)
+    {
+        Expression const &e = done[index];
+        switch (e.op) {
+        case Op::val:
+            return std::to_string(e.value);
+        case Op::sum:
+            return '('+str(done, e.a)+" + "+str(done, e.b)+')';
+        case Op::sub:
+            return '('+str(done, e.a)+" - "+str(done, e.b)+')';
+        case Op::mul:
+            return '('+str(done, e.a)+" * "+str(done, e.b)+')';
+        case Op::div:
+            return '('+str(done, e.a)+" / "+str(done, e.b)+')';
+        }
+        return {};
+    }
+}
+
+// Expressions are taken from the queue in the order of their cost. When one is taken,
+// it is combined with all expressions taken before that use other numbers. Its operands
+// were taken before it because they are cheaper, so every expression is made exactly
+// once, by the later of its two operands. A solution taken from the queue is final:
+// everything cheaper has been taken already.
+// Multisets of numbers are numbers in a mixed radix system like in solution-count.cpp,
+// so that equal numbers do not make the same expression twice.
+std::vector<RankedSolution> simplestSolutions(std::vector<int> const &numbers, int const target,
+                                              std::size_t const k, CostModel const &model)
+{
+    std::vector<RankedSolution> ranked;
+    // without a solution there is no bound and the search would have to make everything
+    if (k == 0 or not reachable(subsetValues(numbers, maxLimit), target)) return ranked;
+
+    std::vector<int> sorted(numbers);
+    std::sort(std::begin(sorted), std::end(sorted));
+    std::vector<int> distinct;
+    std::vector<unsigned> multiplicity;
+    for (int const n : sorted) {
+        if (not std::empty(distinct) and distinct.back() == n) ++multiplicity.back();
+        else {
+            distinct.push_back(n);
+            multiplicity.push_back(1);
+        }
+    }
+    std::vector<std::uint32_t> radix(std::size(distinct));
+    std::uint32_t nmultisets = 1;
+    for (std::size_t d = 0; d < std::size(distinct); ++d) {
+        radix[d] = nmultisets;
+        nmultisets *= multiplicity[d] + 1;
+    }
+    auto const digit = [&](std::uint32_t const set, std::size_t const d) {
+        return set / radix[d] % (multiplicity[d] + 1);
+    };
+    std::uint32_t const all = nmultisets - 1;
+
+    std::priority_queue<Expression, std::vector<Expression>, Later> queue;
+    for (std::size_t d = 0; d < std::size(distinct); ++d) {
+        queue.push({distinct[d], 0, Op::val, 0, 0, radix[d]});
+    }
+
+    // expressions taken from the queue, and their indices by multiset
+    std::vector<Expression> done;
+    std::vector<std::vector<std::uint32_t>> byMultiset(nmultisets);
+
+    // Costs of the k cheapest solutions pushed so far, the largest on top. Nothing more
+    // expensive than the top can be part of the answer once there are k of them.
+    std::priority_queue<int> bestCosts;
+    auto const bound = [&] {
+        return std::size(bestCosts) < k ? std::numeric_limits<int>::max() : bestCosts.top();
+    };
+    // the cheapest possible operation that makes target, the last one of every solution
+    int const finalCost = model.operation + model.digit * digits(target);
+
+    constexpr std::array ops{Op::sum, Op::sub, Op::mul, Op::div};
+    std::vector<unsigned> free(std::size(distinct)), part(std::size(distinct));
+
+    while (not std::empty(queue)) {
+        Expression const e = queue.top();
+        queue.pop();
+        // all solutions of this cost are in the queue before anything of this cost is taken
+        if (std::size(ranked) >= k and e.cost > ranked.back().cost) break;
+
+        auto const index = static_cast<std::uint32_t>(std::size(done));
+        done.push_back(e);
+        byMultiset[e.multiset].push_back(index);
+        if (e.value == target and e.op != Op::val) {
+            ranked.push_back({str(done, index), e.cost});
+        }
+
+        // combine with everything taken so far that uses numbers not used by e
+        std::uint32_t const rest = all - e.multiset;
+        if (rest == 0) continue;
+        for (std::size_t d = 0; d < std::size(distinct); ++d) free[d] = digit(rest, d);
+        std::fill(std::begin(part), std::end(part), 0u);
+        for (std::uint32_t other = 0;;) {
+            // next sub-multiset of rest
+            std::size_t d = 0;
+            while (d < std::size(part) and part[d] == free[d]) {
+                other -= part[d] * radix[d];
+                part[d++] = 0;
+            }
+            if (d == std::size(part)) break;
+            ++part[d];
+            other += radix[d];
+
+            for (std::uint32_t const j : byMultiset[other]) {
+                Expression const &f = done[j];
+                // only try every pair once: the order that is ok for sub
+                if (e.value == f.value) continue;
+                bool const eFirst = e.value > f.value;
+                int const a = eFirst ? e.value : f.value;
+                int const b = eFirst ? f.value : e.value;
+
+                for (auto const op : ops) {
+                    long long value = 0;
+                    switch (op) {
+                    case Op::sum: value = static_cast<long long>(a) + b; break;
+                    case Op::sub: value = a - b; break;
+                    case Op::mul: value = static_cast<long long>(a) * b; break;
+                    case Op::div:
+                        // skip divisions with remainder
+                        if (a % b != 0) continue;
+                        value = a / b;
+                        break;
+                    case Op::val: break;
+                    }
+                    if (value > maxLimit) continue;
+
+                    int const v = static_cast<int>(value);
+                    int const cost = e.cost + f.cost + model.operation + model.digit * digits(v)
+                        + (op == Op::div ? model.division : 0);
+                    // cannot be part of one of the k cheapest solutions
+                    if (cost > bound() or (v != target and cost + finalCost > bound())) continue;
+
+                    if (v == target) {
+                        bestCosts.push(cost);
+                        if (std::size(bestCosts) > k) bestCosts.pop();
+                    }
+                    queue.push({v, cost, op, eFirst ? index : j, eFirst ? j : index,
+                                e.multiset + other});
+                }
+            }
+        }
+    }
+
+    std::sort(std::begin(ranked), std::end(ranked), [](auto const &l, auto const &r) {
+        return l.cost != r.cost ? l.cost < r.cost : l.expression < r.expression;
+    });
+    if (std::size(ranked) > k) ranked.resize(k);
+    return ranked;
+}
+
+}  // namespace countdown
@@ -0,0 +1,45 @@
+/*
+ * Best-first search for the simplest solutions.
+ *
+ * Instead of going depth first through all combinations, partial expressions are
+ * taken from a priority queue in the order of their cost and only then combined into
+ * larger ones. Every operation has a cost that grows with the size of its result and is
+ * higher for divisions. The cost of an expression is the sum over its operations, so a
+ * solution is proven to be among the cheapest once everything cheaper has been taken.
+ * The search stops as soon as the k cheapest solutions are known, and expressions that
+ * are too expensive to be part of them are never queued.
+ */
+
+#ifndef COUNTDOWN_BEST_FIRST_HPP
+#define COUNTDOWN_BEST_FIRST_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace countdown {
+
+// cost of one operation: operation + digit * (decimal digits of the result)
+//                        + division if it is a division
+// operation must be positive so that longer solutions always cost more
+struct CostModel
+{
+    int operation = 10;
+    int digit = 1;
+    int division = 5;
+};
+
+struct RankedSolution
+{
+    std::string expression;
+    int cost;
+};
+
+// The k cheapest distinct solutions for target, cheapest first, ties sorted by
+// expression. Returns fewer if there are not as many.
+std::vector<RankedSolution> simplestSolutions(std::vector<int> const &numbers, int target,
+                                              std::size_t k, CostModel const &model = {});
+
+}  // namespace countdown
+
+#endif  // COUNTDOWN_BEST_FIRST_HPP
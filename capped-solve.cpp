@@ -0,0 +1,128 @@
+#include "capped-solve.hpp"
+#include "raw-engine.hpp"
+#include "solution-count.hpp"
+#include "trace.hpp"
+
+#include <algorithm>
+#include <random>
+#include <unordered_set>
+
+namespace countdown {
+
+namespace {
+    std::size_t footprint(std::string const &s)
+    {
+        // short strings live inside the object
+        return sizeof(std::string) + (s.capacity() >= sizeof(std::string) ? s.capacity() + 1 : 0);
+    }
+
+    void sortUnique(std::vector<std::string> &solutions)
+    {
+        std::sort(std::begin(solutions), std::end(solutions));
+        solutions.erase(std::unique(std::begin(solutions), std::end(solutions)),
+                        std::end(solutions));
+    }
+
+    using Hashes = std::unordered_set<std::uint64_t>;
+
+    // bytes of one element of a Hashes on top of its bucket: the value and the link
+    constexpr std::size_t hashNodeBytes = sizeof(std::uint64_t) + sizeof(void*);
+
+    // the bucket array and the nodes of seen
+    std::size_t footprint(Hashes const &seen)
+    {
+        return seen.bucket_count() * sizeof(void*) + std::size(seen) * hashNodeBytes;
+    }
+}
+
+std::size_t footprint(std::vector<std::string> const &solutions)
+{
+    std::size_t bytes = (solutions.capacity() - std::size(solutions)) * sizeof(std::string);
+    for (auto const &s : solutions) bytes += footprint(s);
+    return bytes;
+}
+
+CappedSolutions solveCapped(std::vector<int> const &numbers, int const target,
+                            std::size_t const budget)
+{
+    trace::Scope search("search");
+    CappedSolutions result;
+    auto &kept = result.solutions;
+    // footprint of kept
+    std::size_t used = 0;
+    // hashes of the distinct solutions seen once sampling started, room for maxSeen of
+    // them is reserved up front so that the bucket array never grows
+    Hashes seen;
+    std::size_t maxSeen = 0;
+    // fixed seed, the same draw gives the same sample
+    std::mt19937_64 random{static_cast<std::uint64_t>(target)};
+
+    auto const numberNodes = raw::toNodes(numbers);
+    raw::forEachSolution(raw::toPointers(numberNodes), target, [&](raw::Node &node) {
+        if (not result.sampled) {
+            kept.push_back(raw::to_string(node));
+            used += footprint(kept.back());
+            if (used <= budget) return;
+
+            // maybe duplicates are all that is in the way
+            result.deduplicatedEarly = true;
+            sortUnique(kept);
+            kept.shrink_to_fit();
+            used = footprint(kept);
+            // leave room to grow, or this would sort again on every solution
+            if (used <= budget / 2) return;
+
+            // Dropping random ones keeps the rest a uniform sample. The sample gets half
+            // of the budget, seen the other half. seen also holds the ones dropped here,
+            // they are only gone from the sample.
+            result.sampled = true;
+            std::vector<std::uint64_t> hashes;
+            for (auto const &solution : kept) hashes.push_back(std::hash<std::string>{}(solution));
+            std::shuffle(std::begin(kept), std::end(kept), random);
+            while (not std::empty(kept) and used > budget / 2) {
+                used -= footprint(kept.back());
+                kept.pop_back();
+            }
+            kept.shrink_to_fit();
+            used = footprint(kept);
+
+            // buckets and nodes of about the same size, with the default load factor
+            maxSeen = (budget - used) / (sizeof(void*) + hashNodeBytes);
+            seen.reserve(maxSeen);
+            seen.insert(std::begin(hashes), std::end(hashes));
+            result.truncated = std::size(seen) > maxSeen or used + footprint(seen) > budget;
+            return;
+        }
+        if (result.truncated) return;
+
+        auto solution = raw::to_string(node);
+        auto const hash = std::hash<std::string>{}(solution);
+        if (seen.count(hash)) return;
+
+        // replace a random sample with probability size / seen
+        std::uniform_int_distribution<std::uint64_t> pick{0, std::size(seen)};
+        auto const i = pick(random);
+        std::size_t const replaced = i < std::size(kept) ? footprint(kept[i]) : 0;
+        std::size_t const grown = i < std::size(kept) ? footprint(solution) : 0;
+        // a solution that does not fit anymore ends the sampling as if it was never seen
+        if (std::size(seen) == maxSeen
+            or used - replaced + grown + footprint(seen) + hashNodeBytes > budget) {
+            result.truncated = true;
+            return;
+        }
+
+        seen.insert(hash);
+        if (i < std::size(kept)) {
+            kept[i] = std::move(solution);
+            used = used - replaced + grown;
+        }
+    });
+    search.close();
+
+    trace::Scope const dedup("dedup");
+    sortUnique(kept);
+    result.count = result.sampled ? countSolutions(numbers, target) : std::size(kept);
+    return result;
+}
+
+}  // namespace countdown
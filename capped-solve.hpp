@@ -0,0 +1,58 @@
+/*
+ * Solve within a memory budget.
+ *
+ * Draws with many solutions need a lot of memory for the strings of all of them.
+ * Here the strings are kept as long as they fit into a budget. When they no longer fit,
+ * the duplicates are dropped first, and if that does not free enough, the search goes
+ * on keeping only a sample of the solutions and the number of distinct solutions is
+ * counted in a DP that does not make expressions at all.
+ *
+ * The search finds most solutions several times. To sample the distinct solutions
+ * uniformly (reservoir sampling), the 64 bit hashes of all solutions seen so far are
+ * kept in a set. The sample and the set share the budget, the sample starts with half
+ * of it. Once the next distinct solution would not fit, sampling stops and the sample
+ * is uniform only over the distinct solutions found until then.
+ *
+ * The budget covers the strings, the sample, and the set of hashes. The DP that counts
+ * the solutions once sampling started keeps the counts of all values of every
+ * sub-multiset of the numbers and is not part of it.
+ */
+
+#ifndef COUNTDOWN_CAPPED_SOLVE_HPP
+#define COUNTDOWN_CAPPED_SOLVE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace countdown {
+
+struct CappedSolutions
+{
+    // the distinct solutions, sorted, only a sample of them if sampled is set
+    std::vector<std::string> solutions;
+    // the number of distinct solutions, exact in any case
+    std::uint64_t count = 0;
+
+    // what was given up to stay within the budget:
+    // duplicates were dropped during the search, which costs time
+    bool deduplicatedEarly = false;
+    // solutions only holds a sample, count comes from solution-count.hpp, whose memory
+    // is outside of the budget
+    bool sampled = false;
+    // the set of seen solutions was full, the sample is only drawn from the solutions
+    // found until then
+    bool truncated = false;
+};
+
+// Approximate heap and vector memory that solutions uses.
+std::size_t footprint(std::vector<std::string> const &solutions);
+
+// All distinct solutions for target like countdown::solve() with the raw engine on one
+// thread, as long as their strings fit into budget bytes.
+CappedSolutions solveCapped(std::vector<int> const &numbers, int target, std::size_t budget);
+
+}  // namespace countdown
+
+#endif  // COUNTDOWN_CAPPED_SOLVE_HPP
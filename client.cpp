@@ -0,0 +1,184 @@
+/*
+ * Solve the numbers game from the TV show countdown.
+ *
+ * Client for countdown-server.
+ * Either sends a single query and prints the answer or measures the latency of many
+ * queries for a fixed, seeded set of draws.
+ *
+ * Usage: countdown-client socket-path solve|count|nearest|reachable target numbers...
+ *        countdown-client socket-path bench [requests] [solve|count|nearest|reachable]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "countdown.hpp"
+#include "draws.hpp"
+#include "protocol.hpp"
+
+using namespace countdown;
+
+int connectTo(std::string const &path)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (std::size(path) >= sizeof(address.sun_path)) {
+        throw std::runtime_error("socket path too long");
+    }
+    std::strcpy(address.sun_path, path.c_str());
+
+    int const fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 or ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        throw std::runtime_error("cannot connect to " + path + ": " + std::strerror(errno));
+    }
+    return fd;
+}
+
+protocol::Op parseOp(std::string const &name)
+{
+    if (name == "solve") return protocol::Op::solve;
+    if (name == "count") return protocol::Op::count;
+    if (name == "nearest") return protocol::Op::nearest;
+    if (name == "reachable") return protocol::Op::reachable;
+    throw std::runtime_error("unknown operation " + name);
+}
+
+protocol::Response query(int const fd, protocol::Request const &request)
+{
+    protocol::writeFrame(fd, protocol::encode(request));
+    std::vector<std::uint8_t> payload;
+    if (not protocol::readFrame(fd, payload)) {
+        throw std::runtime_error("server closed the connection");
+    }
+    auto response = protocol::decodeResponse(payload);
+    if (not response.error.empty()) {
+        throw std::runtime_error("server: " + response.error);
+    }
+    return response;
+}
+
+void print(protocol::Response const &response)
+{
+    switch (response.op) {
+    case protocol::Op::solve:
+        for (auto const &solution : response.solutions)
+            std::cout << solution << '\n';
+        std::cout << "There are " << response.count << " 'distinct' solutions\n";
+        if (response.count > std::size(response.solutions)) {
+            std::cout << "The server only kept a sample of " << std::size(response.solutions)
+                      << " of them\n";
+        }
+        break;
+    case protocol::Op::count:
+        std::cout << response.count << '\n';
+        break;
+    case protocol::Op::nearest:
+        std::cout << response.value << '\n';
+        break;
+    case protocol::Op::reachable:
+        for (int const v : response.values)
+            std::cout << v << ' ';
+        std::cout << '\n';
+        break;
+    }
+}
+
+// Draws like in the show (see draws.hpp) with a target between 101 and 999, the same
+// ones with any standard library.
+std::vector<protocol::Request> corpus(std::size_t const size, protocol::Op const op)
+{
+    std::mt19937 rng{20240501};
+    std::vector<protocol::Request> requests;
+    for (std::size_t i = 0; i < size; ++i) {
+        protocol::Request request;
+        request.op = op;
+        request.numbers = randomDraw(rng);
+        request.target = uniform(rng, 101, 999);
+        requests.push_back(request);
+    }
+    return requests;
+}
+
+// Send requests for a corpus of draws, each draw several times so the server's caches
+// get used like in production, and report the latency distribution.
+void bench(int const fd, std::size_t const nrequests, protocol::Op const op)
+{
+    constexpr std::size_t ndraws = 50;
+    auto const draws = corpus(ndraws, op);
+
+    std::vector<double> latencies;
+    for (std::size_t i = 0; i < nrequests; ++i) {
+        auto const start = std::chrono::steady_clock::now();
+        query(fd, draws[i % ndraws]);
+        auto const end = std::chrono::steady_clock::now();
+        latencies.push_back(std::chrono::duration<double, std::micro>(end-start).count());
+    }
+    if (latencies.empty()) return;
+
+    auto const cold = std::vector<double>(std::begin(latencies),
+                                          std::begin(latencies) + std::min(ndraws, nrequests));
+    std::sort(std::begin(latencies), std::end(latencies));
+    auto const percentile = [&](double const p) {
+        auto const i = static_cast<std::size_t>(p / 100 * static_cast<double>(std::size(latencies)-1));
+        return latencies[i];
+    };
+    double mean = 0;
+    for (double const l : latencies) mean += l;
+    mean /= static_cast<double>(std::size(latencies));
+    double coldMean = 0;
+    for (double const l : cold) coldMean += l;
+    coldMean /= static_cast<double>(std::size(cold));
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Requests: " << std::size(latencies) << " over " << ndraws << " draws\n";
+    std::cout << "Latency p50: " << percentile(50) << "us\n";
+    std::cout << "Latency p90: " << percentile(90) << "us\n";
+    std::cout << "Latency p99: " << percentile(99) << "us\n";
+    std::cout << "Latency max: " << latencies.back() << "us\n";
+    std::cout << "Mean: " << mean << "us, first pass over the draws: " << coldMean << "us\n";
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3) {
+        std::cerr << "Usage: countdown-client socket-path solve|count|nearest|reachable target numbers...\n"
+                  << "       countdown-client socket-path bench [requests] [operation]\n";
+        return 1;
+    }
+
+    try {
+        int const fd = connectTo(argv[1]);
+        std::string const command = argv[2];
+        if (command == "bench") {
+            bench(fd,
+                  argc > 3 ? std::stoul(argv[3]) : 1000,
+                  argc > 4 ? parseOp(argv[4]) : protocol::Op::nearest);
+        }
+        else {
+            if (argc < 5) throw std::runtime_error("need a target and numbers");
+            protocol::Request request;
+            request.op = parseOp(command);
+            request.target = std::stoi(argv[3]);
+            for (int i = 4; i < argc; ++i) {
+                request.numbers.push_back(std::stoi(argv[i]));
+            }
+            print(query(fd, request));
+        }
+        ::close(fd);
+    }
+    catch (std::exception const &e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,224 @@
+/*
+ * Collect solutions from many threads without a mutex.
+ *
+ * Every writer thread appends to its own chunk of storage. Full chunks are never moved
+ * or reallocated, a new one is linked in front of the list with a single atomic swap.
+ * Items are published by bumping the size of their chunk, so readers can go through
+ * everything that has been published so far while writers keep adding to it.
+ * Optionally, duplicates are rejected by a lock-free hash set before publishing. The set
+ * has a fixed size, size it for the number of distinct items or check dedupFull().
+ */
+
+#ifndef COUNTDOWN_COLLECTOR_HPP
+#define COUNTDOWN_COLLECTOR_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace countdown {
+
+// Set of pointers to items that compares the items, insert only.
+// Capacity is fixed. Once three quarters of it are used, the set is full: inserting
+// always succeeds without looking at the slots (no more deduplication), so neither the
+// probe sequences nor the cost of an insert grow without bound.
+template <typename T, typename Hash = std::hash<T>>
+class ConcurrentSet
+{
+    std::unique_ptr<std::atomic<T const*>[]> slots_;
+    std::size_t mask_;
+    std::size_t maxSize_;
+    std::atomic<std::size_t> size_{0};
+    std::atomic<bool> full_{false};
+
+public:
+    // capacity is rounded up to a power of two
+    explicit ConcurrentSet(std::size_t const capacity)
+    {
+        std::size_t size = 1;
+        while (size < capacity) size *= 2;
+        slots_ = std::make_unique<std::atomic<T const*>[]>(size);
+        mask_ = size-1;
+        maxSize_ = size - size/4;
+    }
+
+    // Insert item, return false if an equal one is already in the set.
+    // The pointee must not change for the lifetime of the set if this returns true.
+    bool insert(T const *item)
+    {
+        if (full_.load(std::memory_order_relaxed)) return true;
+
+        // linear probing, a slot never changes once it is set
+        std::size_t i = Hash{}(*item) & mask_;
+        for (std::size_t probe = 0; probe <= mask_; ++probe, i = (i+1) & mask_) {
+            T const *current = slots_[i].load(std::memory_order_acquire);
+            if (current == nullptr) {
+                if (slots_[i].compare_exchange_strong(current, item,
+                                                      std::memory_order_acq_rel,
+                                                      std::memory_order_acquire)) {
+                    if (size_.fetch_add(1, std::memory_order_relaxed) + 1 >= maxSize_) {
+                        full_.store(true, std::memory_order_relaxed);
+                    }
+                    return true;
+                }
+                // someone else took the slot, current is now their item
+            }
+            if (*current == *item) return false;
+        }
+        return true;
+    }
+
+    // true once the set stopped deduplicating
+    bool full() const noexcept
+    {
+        return full_.load(std::memory_order_relaxed);
+    }
+};
+
+template <typename T, std::size_t ChunkSize = 1024>
+class Collector
+{
+    struct Chunk
+    {
+        // number of published items
+        std::atomic<std::size_t> size{0};
+        // older chunk, set before this one is linked and never changed afterwards
+        Chunk *next{nullptr};
+        std::array<T, ChunkSize> items{};
+    };
+
+    // newest chunk
+    std::atomic<Chunk*> head_{nullptr};
+    std::unique_ptr<ConcurrentSet<T>> dedup_;
+
+    Chunk *newChunk()
+    {
+        auto chunk = new Chunk;
+        chunk->next = head_.load(std::memory_order_relaxed);
+        while (not head_.compare_exchange_weak(chunk->next, chunk,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed)) { }
+        return chunk;
+    }
+
+public:
+    // Appends items to a chunk owned by one thread, each thread needs its own writer.
+    class Writer
+    {
+        Collector *collector_;
+        Chunk *chunk_{nullptr};
+
+    public:
+        explicit Writer(Collector &collector) noexcept
+            : collector_{&collector}
+        { }
+
+        // Add an item and make it visible to readers.
+        // Returns false and drops the item if deduplication is on and it is a duplicate.
+        bool push(T item)
+        {
+            if (chunk_ == nullptr or chunk_->size.load(std::memory_order_relaxed) == ChunkSize) {
+                chunk_ = collector_->newChunk();
+            }
+
+            // only this thread writes to the chunk, the slot is invisible until size is bumped
+            std::size_t const n = chunk_->size.load(std::memory_order_relaxed);
+            chunk_->items[n] = std::move(item);
+            if (collector_->dedup_ and not collector_->dedup_->insert(&chunk_->items[n])) {
+                return false;
+            }
+            chunk_->size.store(n+1, std::memory_order_release);
+            return true;
+        }
+    };
+
+    // Goes through published items, can be used while writers are active.
+    class Reader
+    {
+        Collector const *collector_;
+        // chunks seen so far, newest first, with the number of items already read
+        std::vector<std::pair<Chunk const*, std::size_t>> seen_;
+
+    public:
+        explicit Reader(Collector const &collector) noexcept
+            : collector_{&collector}
+        { }
+
+        // Call f(item) for every item published since the last call, return their number.
+        // Items of one writer are visited in the order they were pushed.
+        template <typename F>
+        std::size_t poll(F &&f)
+        {
+            // chunks are only ever added in front, so new ones come before the known ones
+            Chunk const *const known = std::empty(seen_) ? nullptr : seen_.front().first;
+            std::vector<std::pair<Chunk const*, std::size_t>> fresh;
+            for (Chunk const *chunk = collector_->head_.load(std::memory_order_acquire);
+                 chunk != known; chunk = chunk->next) {
+                fresh.emplace_back(chunk, 0);
+            }
+            seen_.insert(std::begin(seen_), std::begin(fresh), std::end(fresh));
+
+            std::size_t count = 0;
+            for (auto it = std::rbegin(seen_); it != std::rend(seen_); ++it) {
+                auto &[chunk, read] = *it;
+                std::size_t const size = chunk->size.load(std::memory_order_acquire);
+                for (; read < size; ++read, ++count) {
+                    f(chunk->items[read]);
+                }
+            }
+            return count;
+        }
+    };
+
+    // dedupCapacity > 0 turns on deduplication with a hash set of that many slots
+    explicit Collector(std::size_t const dedupCapacity = 0)
+    {
+        if (dedupCapacity > 0) {
+            dedup_ = std::make_unique<ConcurrentSet<T>>(dedupCapacity);
+        }
+    }
+
+    Collector(Collector const &) = delete;
+    Collector &operator=(Collector const &) = delete;
+
+    ~Collector()
+    {
+        for (Chunk *chunk = head_.load(std::memory_order_acquire); chunk != nullptr; ) {
+            Chunk *const next = chunk->next;
+            delete chunk;
+            chunk = next;
+        }
+    }
+
+    // true if deduplication is on but its set filled up, so items may repeat
+    bool dedupFull() const noexcept
+    {
+        return dedup_ and dedup_->full();
+    }
+
+    Writer writer() noexcept
+    {
+        return Writer{*this};
+    }
+
+    Reader reader() const noexcept
+    {
+        return Reader{*this};
+    }
+
+    // all items published so far
+    std::vector<T> items() const
+    {
+        std::vector<T> all;
+        reader().poll([&](T const &item) { all.push_back(item); });
+        return all;
+    }
+};
+
+}  // namespace countdown
+
+#endif  // COUNTDOWN_COLLECTOR_HPP
@@ -0,0 +1,208 @@
+#include "combine.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define COUNTDOWN_HAVE_AVX2_KERNEL 1
+#include <immintrin.h>
+#else
+#define COUNTDOWN_HAVE_AVX2_KERNEL 0
+#endif
+
+namespace countdown {
+
+namespace {
+    // make sure out can hold another n values past size (plus slack for full vector stores)
+    int *reserveTail(std::vector<int> &out, std::size_t const size, std::size_t const n)
+    {
+        if (std::size(out) < size + n) {
+            out.resize(std::max(2*std::size(out), size + n));
+        }
+        return out.data() + size;
+    }
+}
+
+void combineScalar(std::vector<int> const &a, std::vector<int> const &b,
+                   int const limit, std::vector<int> &out)
+{
+    for (int const x : a) {
+        for (int const y : b) {
+            // only try every pair once: the order that is ok for sub
+            if (x == y) continue;
+            int const hi = std::max(x, y);
+            int const lo = std::min(x, y);
+
+            if (hi + lo <= limit) out.push_back(hi + lo);
+            out.push_back(hi - lo);
+            if (static_cast<std::int64_t>(hi) * lo <= limit) out.push_back(hi * lo);
+            // skip divisions with remainder
+            if (hi % lo == 0) out.push_back(hi / lo);
+        }
+    }
+}
+
+#if COUNTDOWN_HAVE_AVX2_KERNEL
+
+namespace {
+    // Permutations that move the selected lanes of an 8 x int32 vector to the front.
+    // Indexed by the movemask of the selection, emulates AVX-512 compress-store.
+    constexpr auto makeCompressTable()
+    {
+        std::array<std::array<std::int32_t, 8>, 256> table{};
+        for (unsigned mask = 0; mask < 256; ++mask) {
+            unsigned n = 0;
+            for (unsigned lane = 0; lane < 8; ++lane) {
+                if (mask & (1u << lane)) {
+                    table[mask][n++] = static_cast<std::int32_t>(lane);
+                }
+            }
+        }
+        return table;
+    }
+
+    alignas(32) constexpr auto compressTable = makeCompressTable();
+
+    // store the lanes of v selected by valid contiguously at out, return the number stored
+    __attribute__((target("avx2")))
+    inline std::size_t compressStore(int *out, __m256i const v, __m256i const valid)
+    {
+        unsigned const mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(valid)));
+        __m256i const perm = _mm256_load_si256(
+            reinterpret_cast<__m256i const*>(compressTable[mask].data()));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out),
+                            _mm256_permutevar8x32_epi32(v, perm));
+        return static_cast<std::size_t>(__builtin_popcount(mask));
+    }
+
+    // hi * lo if it fits into [0, limit], the mask is set for lanes where it does
+    __attribute__((target("avx2")))
+    inline __m256i mulChecked(__m256i const hi, __m256i const lo, __m256i const limit,
+                              __m256i &valid)
+    {
+        // 64-bit products of the even and odd lanes
+        __m256i const even = _mm256_mul_epu32(hi, lo);
+        __m256i const odd = _mm256_mul_epu32(_mm256_srli_epi64(hi, 32), _mm256_srli_epi64(lo, 32));
+        __m256i const low = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+        __m256i const high = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+
+        __m256i const zero = _mm256_setzero_si256();
+        valid = _mm256_and_si256(_mm256_cmpeq_epi32(high, zero),
+                                 _mm256_andnot_si256(_mm256_cmpgt_epi32(low, limit),
+                                                     _mm256_cmpgt_epi32(low, zero)));
+        return low;
+    }
+
+    // hi / lo truncated, the mask is set for lanes without remainder
+    __attribute__((target("avx2")))
+    inline __m256i divExact(__m256i const hi, __m256i const lo, __m256i &valid)
+    {
+        // doubles represent all ints exactly and an inexact quotient can never round to an integer
+        __m128i const qlow = _mm256_cvttpd_epi32(
+            _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(hi)),
+                          _mm256_cvtepi32_pd(_mm256_castsi256_si128(lo))));
+        __m128i const qhigh = _mm256_cvttpd_epi32(
+            _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(hi, 1)),
+                          _mm256_cvtepi32_pd(_mm256_extracti128_si256(lo, 1))));
+        __m256i const q = _mm256_set_m128i(qhigh, qlow);
+        valid = _mm256_cmpeq_epi32(_mm256_mullo_epi32(q, lo), hi);
+        return q;
+    }
+}
+
+__attribute__((target("avx2")))
+void combineAvx2(std::vector<int> const &a, std::vector<int> const &b,
+                 int const limit, std::vector<int> &out)
+{
+    std::size_t const nb = std::size(b);
+    // room for 4 results per pair in one row plus one full store of slack
+    std::size_t const rowSize = 4*(nb+8) + 8;
+
+    __m256i const vlimit = _mm256_set1_epi32(limit);
+    __m256i const lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    std::size_t n = std::size(out);
+    for (int const x : a) {
+        int *dst = reserveTail(out, n, rowSize);
+        __m256i const vx = _mm256_set1_epi32(x);
+
+        for (std::size_t j = 0; j < nb; j += 8) {
+            // lanes past the end of b are masked out
+            __m256i const inRange = _mm256_cmpgt_epi32(
+                _mm256_set1_epi32(static_cast<int>(nb - j)), lanes);
+            __m256i const vy = _mm256_maskload_epi32(b.data() + j, inRange);
+
+            __m256i const hi = _mm256_max_epi32(vx, vy);
+            __m256i const lo = _mm256_min_epi32(vx, vy);
+            // only try every pair once: the order that is ok for sub
+            __m256i const pair = _mm256_and_si256(inRange, _mm256_cmpgt_epi32(hi, lo));
+
+            __m256i const sum = _mm256_add_epi32(hi, lo);
+            dst += compressStore(dst, sum,
+                                 _mm256_andnot_si256(_mm256_cmpgt_epi32(sum, vlimit), pair));
+
+            dst += compressStore(dst, _mm256_sub_epi32(hi, lo), pair);
+
+            __m256i mulValid;
+            __m256i const prod = mulChecked(hi, lo, vlimit, mulValid);
+            dst += compressStore(dst, prod, _mm256_and_si256(pair, mulValid));
+
+            // masked lanes have lo == 0, make them divide by one instead
+            __m256i const divisor = _mm256_blendv_epi8(_mm256_set1_epi32(1), lo, pair);
+            __m256i divValid;
+            __m256i const quot = divExact(hi, divisor, divValid);
+            dst += compressStore(dst, quot, _mm256_and_si256(pair, divValid));
+        }
+
+        n = static_cast<std::size_t>(dst - out.data());
+    }
+    out.resize(n);
+}
+
+bool haveAvx2() noexcept
+{
+    static bool const have = __builtin_cpu_supports("avx2");
+    return have;
+}
+
+#else
+
+void combineAvx2(std::vector<int> const &a, std::vector<int> const &b,
+                 int const limit, std::vector<int> &out)
+{
+    // never selected, fall back in case someone calls it anyway
+    combineScalar(a, b, limit, out);
+}
+
+bool haveAvx2() noexcept
+{
+    return false;
+}
+
+#endif
+
+namespace {
+    using CombineFn = void(*)(std::vector<int> const&, std::vector<int> const&,
+                              int, std::vector<int>&);
+
+    // pick the kernel once, based on what the CPU we are running on supports
+    CombineFn selectKernel() noexcept
+    {
+        return haveAvx2() ? combineAvx2 : combineScalar;
+    }
+}
+
+void combine(std::vector<int> const &a, std::vector<int> const &b,
+             int const limit, std::vector<int> &out)
+{
+    static CombineFn const kernel = selectKernel();
+    kernel(a, b, limit, out);
+}
+
+char const *combineKernel() noexcept
+{
+    return haveAvx2() ? "avx2" : "scalar";
+}
+
+}  // namespace countdown
@@ -0,0 +1,44 @@
+/*
+ * Combine two lists of values with all four operations.
+ *
+ * This is the inner loop of the subset DP: every value of one subset is paired with
+ * every value of another and the valid results of +, -, *, / are collected.
+ * The validity rules are the same as in solve():
+ *  - only pairs with a > b are used (the order that is ok for sub),
+ *  - divisions with remainder are skipped,
+ *  - results larger than a limit are dropped to stay within int.
+ */
+
+#ifndef COUNTDOWN_COMBINE_HPP
+#define COUNTDOWN_COMBINE_HPP
+
+#include <vector>
+
+namespace countdown {
+
+// Pair every value in a with every value in b and append the results to out.
+// All inputs must be in [1, limit] and limit must not exceed maxLimit.
+// Results are appended in no particular order and may contain duplicates.
+void combine(std::vector<int> const &a, std::vector<int> const &b,
+             int limit, std::vector<int> &out);
+
+// The portable implementation used when the CPU has no AVX2.
+void combineScalar(std::vector<int> const &a, std::vector<int> const &b,
+                   int limit, std::vector<int> &out);
+
+// The vectorised implementation, must only be called if haveAvx2() is true.
+void combineAvx2(std::vector<int> const &a, std::vector<int> const &b,
+                 int limit, std::vector<int> &out);
+
+// true if this binary was built with the AVX2 kernel and the CPU supports it.
+bool haveAvx2() noexcept;
+
+// name of the kernel selected by combine()
+char const *combineKernel() noexcept;
+
+// largest allowed limit, sums of two values must fit into int
+constexpr int maxLimit = (1 << 30) - 1;
+
+}  // namespace countdown
+
+#endif  // COUNTDOWN_COMBINE_HPP
@@ -0,0 +1,457 @@
+/*
+ * Compare all engines on a fixed corpus of draws.
+ *
+ * The corpus is generated from a seed with the rules of the show (up to four of
+ * 25, 50, 75, 100 and the rest from two sets of 1 to 10, targets from 101 to 999)
+ * and sorted into four kinds of draws:
+ *   easy         - the target has many distinct solutions
+ *   hard         - the target has only a few distinct solutions
+ *   unsolvable   - the target cannot be made
+ *   duplicates   - draws with at most three distinct numbers
+ * The same seed always gives the same corpus.
+ *
+ * The tree engines solve every draw, the value engines only find the nearest value
+ * because that is all they can do. Every engine runs every draw a few times and the
+ * table shows the median and percentiles of all runs of a kind, how many expression
+ * nodes the tree engines make per second, and the allocations and peak live heap
+ * memory per run. The timed runs count nothing, like production code. The nodes and
+ * allocations are taken from one extra run of every draw that is not timed.
+ *
+ * --write-baseline file.json stores the median times and node rates together with the
+ * corpus parameters. --baseline file.json runs the corpus of a stored baseline again
+ * and exits with 1 if a median is more than the tolerance (and at least 1ms) slower or
+ * a node rate more than the tolerance lower than in the baseline. The tolerance is
+ * stored in the baseline (0.2 by default) and can be overridden with --tolerance.
+ * A baseline only compares with runs on the same machine.
+ * Usage: countdown-bench [--runs N] [--draws N] [--seed S] [-j threads]
+ *                        [--write-baseline file | --baseline file [--tolerance T]]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <fstream>
+#include <map>
+#include <iterator>
+#include <stdexcept>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <thread>
+
+#include "alloc-tracker.hpp"
+#include "countdown.hpp"
+#include "draws.hpp"
+
+using namespace countdown;
+
+struct Draw
+{
+    std::vector<int> numbers;
+    int target;
+};
+
+struct Kind
+{
+    std::string name;
+    std::vector<Draw> draws;
+};
+
+std::vector<int> duplicateNumbers(std::mt19937 &rng)
+{
+    std::vector<int> distinct;
+    int const nDistinct = uniform(rng, 1, 3);
+    while (static_cast<int>(std::size(distinct)) < nDistinct) {
+        int const n = uniform(rng, 1, 10);
+        if (std::find(std::begin(distinct), std::end(distinct), n) == std::end(distinct)) {
+            distinct.push_back(n);
+        }
+    }
+
+    std::vector<int> numbers;
+    for (int i = 0; i < 6; ++i) {
+        numbers.push_back(distinct[static_cast<std::size_t>(uniform(rng, 0, nDistinct - 1))]);
+    }
+    return numbers;
+}
+
+// Draw random puzzles until every kind has perDraw of them.
+// Only the distinct solutions count, the duplicates in terms of associativity do not.
+std::vector<Kind> makeCorpus(std::size_t const perKind, unsigned const seed)
+{
+    constexpr std::size_t easyMin = 50;
+    constexpr std::size_t hardMax = 5;
+
+    std::mt19937 rng(seed);
+    Kind easy{"easy", {}}, hard{"hard", {}}, unsolvable{"unsolvable", {}}, duplicates{"duplicates", {}};
+    Options const values{Engine::values};
+
+    while (std::size(easy.draws) < perKind or std::size(hard.draws) < perKind
+           or std::size(unsolvable.draws) < perKind) {
+        Draw draw{randomDraw(rng), uniform(rng, 101, 999)};
+        if (nearest(draw.numbers, draw.target, values) != draw.target) {
+            if (std::size(unsolvable.draws) < perKind) unsolvable.draws.push_back(draw);
+            continue;
+        }
+
+        std::size_t const n = count(draw.numbers, draw.target);
+        if (n >= easyMin and std::size(easy.draws) < perKind) easy.draws.push_back(draw);
+        else if (n <= hardMax and std::size(hard.draws) < perKind) hard.draws.push_back(draw);
+    }
+
+    while (std::size(duplicates.draws) < perKind) {
+        Draw draw{duplicateNumbers(rng), uniform(rng, 101, 999)};
+        // take the nearest reachable value so that there is something to find
+        draw.target = nearest(draw.numbers, draw.target, values);
+        if (draw.target != 0) duplicates.draws.push_back(draw);
+    }
+
+    return {easy, hard, unsolvable, duplicates};
+}
+
+struct Candidate
+{
+    std::string name;
+    Options options;
+    // tree engines solve, value engines can only find the nearest value
+    bool tree;
+};
+
+// element at fraction p of the sorted times, nearest rank
+double percentile(std::vector<double> const &sorted, double const p)
+{
+    auto const rank = static_cast<std::size_t>(p * static_cast<double>(std::size(sorted) - 1) + 0.5);
+    return sorted[rank];
+}
+
+struct Result
+{
+    std::string kind;
+    std::string engine;
+    double p50, p90, p99;
+    // only for tree engines, 0 otherwise
+    double mnodesPerSecond;
+    std::uint64_t allocations;
+    std::uint64_t peak;
+};
+
+// The timed runs are what production runs: no search stats and no allocation counting.
+// The nodes and allocations come from one more run of every draw that is not timed.
+Result measure(Kind const &kind, Candidate const &engine, std::size_t const runs)
+{
+    auto const run = [&](Draw const &draw, Options const &options) {
+        if (engine.tree) solve(draw.numbers, draw.target, options);
+        else nearest(draw.numbers, draw.target, options);
+    };
+
+    std::vector<double> times;
+    countAllocations(false);
+    for (auto const &draw : kind.draws) {
+        for (std::size_t i = 0; i < runs; ++i) {
+            auto const start = std::chrono::steady_clock::now();
+            run(draw, engine.options);
+            auto const end = std::chrono::steady_clock::now();
+            times.push_back(std::chrono::duration<double, std::milli>(end-start).count());
+        }
+    }
+    countAllocations(true);
+
+    SearchStats stats;
+    std::uint64_t allocations = 0;
+    std::uint64_t peak = 0;
+    for (auto const &draw : kind.draws) {
+        Options options = engine.options;
+        options.stats = &stats;
+        resetAllocStats();
+        run(draw, options);
+        auto const alloc = allocStats();
+        allocations += alloc.allocations;
+        peak = std::max(peak, alloc.peak);
+    }
+
+    std::sort(std::begin(times), std::end(times));
+    double total = 0;
+    for (double ms : times) total += ms;
+    // every timed run of a draw makes as many nodes as the counted one
+    auto const nodes = static_cast<double>(stats.nodes) * static_cast<double>(runs);
+
+    return {kind.name, engine.name,
+            percentile(times, 0.5), percentile(times, 0.9), percentile(times, 0.99),
+            engine.tree ? nodes / total / 1000.0 : 0.0,
+            allocations / std::size(kind.draws), peak};
+}
+
+// Baselines of another version measured something else and cannot be compared.
+// Version 2 times the runs without stats and allocation counting.
+constexpr int baselineVersion = 2;
+
+struct Baseline
+{
+    int version = baselineVersion;
+    std::size_t runs = 5;
+    std::size_t perKind = 3;
+    unsigned seed = 1;
+    unsigned threads = 1;
+    double tolerance = 0.2;
+    // (kind, engine) -> (median ms, Mnodes/s)
+    std::map<std::pair<std::string, std::string>, std::pair<double, double>> results;
+};
+
+void writeBaseline(std::ostream &os, Baseline const &baseline, std::vector<Result> const &results)
+{
+    os << "{\n  \"version\": " << baselineVersion << ",\n  \"runs\": " << baseline.runs << ",\n  \"draws\": " << baseline.perKind
+       << ",\n  \"seed\": " << baseline.seed << ",\n  \"threads\": " << baseline.threads
+       << ",\n  \"tolerance\": " << baseline.tolerance << ",\n  \"results\": [";
+    for (std::size_t i = 0; i < std::size(results); ++i) {
+        auto const &result = results[i];
+        os << (i == 0 ? "\n" : ",\n") << std::fixed << std::setprecision(3)
+           << "    {\"kind\": \"" << result.kind << "\", \"engine\": \"" << result.engine
+           << "\", \"p50_ms\": " << result.p50
+           << ", \"mnodes_per_s\": " << result.mnodesPerSecond << '}';
+    }
+    os << "\n  ]\n}\n";
+}
+
+// Reads what writeBaseline() writes: one object of numbers and an array of flat objects
+// of strings and numbers. Throws std::runtime_error for anything else.
+Baseline readBaseline(std::istream &is)
+{
+    std::string const text{std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>()};
+    std::size_t pos = 0;
+
+    auto const fail = [&](std::string const &what) {
+        throw std::runtime_error("bad baseline at offset " + std::to_string(pos) + ": " + what);
+    };
+    auto const skipSpace = [&] {
+        while (pos < std::size(text) and std::isspace(static_cast<unsigned char>(text[pos]))) ++pos;
+    };
+    auto const expect = [&](char const c) {
+        skipSpace();
+        if (pos >= std::size(text) or text[pos] != c) fail(std::string("expected ") + c);
+        ++pos;
+    };
+    auto const peek = [&] {
+        skipSpace();
+        return pos < std::size(text) ? text[pos] : '\0';
+    };
+    auto const string = [&] {
+        expect('"');
+        auto const end = text.find('"', pos);
+        if (end == std::string::npos) fail("unterminated string");
+        std::string value = text.substr(pos, end - pos);
+        pos = end + 1;
+        return value;
+    };
+    auto const number = [&] {
+        skipSpace();
+        char *end = nullptr;
+        double const value = std::strtod(text.c_str() + pos, &end);
+        if (end == text.c_str() + pos) fail("expected a number");
+        pos = static_cast<std::size_t>(end - text.c_str());
+        return value;
+    };
+
+    Baseline baseline;
+    // files without a version are from before versions
+    baseline.version = 1;
+    expect('{');
+    while (peek() != '}') {
+        std::string const key = string();
+        expect(':');
+        if (key == "results") {
+            expect('[');
+            while (peek() != ']') {
+                std::map<std::string, std::string> strings;
+                std::map<std::string, double> numbers;
+                expect('{');
+                while (peek() != '}') {
+                    std::string const field = string();
+                    expect(':');
+                    if (peek() == '"') strings[field] = string();
+                    else numbers[field] = number();
+                    if (peek() == ',') ++pos;
+                }
+                expect('}');
+                baseline.results[{strings["kind"], strings["engine"]}]
+                    = {numbers["p50_ms"], numbers["mnodes_per_s"]};
+                if (peek() == ',') ++pos;
+            }
+            expect(']');
+        }
+        else {
+            double const value = number();
+            if (key == "version") baseline.version = static_cast<int>(value);
+            else if (key == "runs") baseline.runs = static_cast<std::size_t>(value);
+            else if (key == "draws") baseline.perKind = static_cast<std::size_t>(value);
+            else if (key == "seed") baseline.seed = static_cast<unsigned>(value);
+            else if (key == "threads") baseline.threads = static_cast<unsigned>(value);
+            else if (key == "tolerance") baseline.tolerance = value;
+        }
+        if (peek() == ',') ++pos;
+    }
+    expect('}');
+    if (baseline.version != baselineVersion) {
+        throw std::runtime_error("baseline version " + std::to_string(baseline.version)
+                                 + " instead of " + std::to_string(baselineVersion)
+                                 + ", record it again");
+    }
+    return baseline;
+}
+
+// Print every result that is worse than the baseline allows, return their number.
+std::size_t compare(Baseline const &baseline, std::vector<Result> const &results)
+{
+    // differences of the fast engines below this are only timer and scheduler noise
+    constexpr double noiseMs = 1.0;
+
+    std::size_t regressions = 0;
+    std::cout << std::fixed << std::setprecision(2);
+    for (auto const &result : results) {
+        auto const it = baseline.results.find({result.kind, result.engine});
+        if (it == std::end(baseline.results)) {
+            std::cout << result.kind << ' ' << result.engine << ": not in the baseline\n";
+            continue;
+        }
+        auto const [p50, mnodes] = it->second;
+
+        if (result.p50 > p50 * (1.0 + baseline.tolerance) and result.p50 - p50 > noiseMs) {
+            std::cout << "REGRESSION " << result.kind << ' ' << result.engine << ": median "
+                      << result.p50 << "ms, baseline " << p50 << "ms\n";
+            ++regressions;
+        }
+        if (mnodes > 0 and result.mnodesPerSecond < mnodes * (1.0 - baseline.tolerance)) {
+            std::cout << "REGRESSION " << result.kind << ' ' << result.engine << ": "
+                      << result.mnodesPerSecond << " Mnodes/s, baseline " << mnodes << " Mnodes/s\n";
+            ++regressions;
+        }
+    }
+    return regressions;
+}
+
+int main(int argc, char *argv[])
+{
+    Baseline settings;
+    settings.threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string writePath, baselinePath;
+    double tolerance = -1;
+    for (int i = 1; i < argc; ++i) {
+        std::string const arg = argv[i];
+        if (arg == "--runs" and i+1 < argc) {
+            settings.runs = std::max<std::size_t>(1, std::stoul(argv[++i]));
+        }
+        else if (arg == "--draws" and i+1 < argc) {
+            settings.perKind = std::max<std::size_t>(1, std::stoul(argv[++i]));
+        }
+        else if (arg == "--seed" and i+1 < argc) {
+            settings.seed = static_cast<unsigned>(std::stoul(argv[++i]));
+        }
+        else if (arg == "-j" and i+1 < argc) {
+            settings.threads = std::max(1u, static_cast<unsigned>(std::stoul(argv[++i])));
+        }
+        else if (arg == "--write-baseline" and i+1 < argc) {
+            writePath = argv[++i];
+        }
+        else if (arg == "--baseline" and i+1 < argc) {
+            baselinePath = argv[++i];
+        }
+        else if (arg == "--tolerance" and i+1 < argc) {
+            tolerance = std::stod(argv[++i]);
+        }
+        else {
+            std::cerr << "usage: countdown-bench [--runs N] [--draws N] [--seed S] [-j threads]\n"
+                      << "                       [--write-baseline file | --baseline file [--tolerance T]]\n";
+            return 1;
+        }
+    }
+
+    Baseline baseline;
+    if (not baselinePath.empty()) {
+        std::ifstream file(baselinePath);
+        if (not file) {
+            std::cerr << "cannot open " << baselinePath
+                      << ", record one on this machine with --write-baseline first\n";
+            return 1;
+        }
+        try {
+            baseline = readBaseline(file);
+        }
+        catch (std::runtime_error const &error) {
+            std::cerr << baselinePath << ": " << error.what() << '\n';
+            return 1;
+        }
+        // measure exactly what the baseline measured
+        settings.runs = baseline.runs;
+        settings.perKind = baseline.perKind;
+        settings.seed = baseline.seed;
+        settings.threads = baseline.threads;
+        if (tolerance >= 0) baseline.tolerance = tolerance;
+    }
+    else if (tolerance >= 0) {
+        settings.tolerance = tolerance;
+    }
+
+    auto const corpus = makeCorpus(settings.perKind, settings.seed);
+    std::cout << "corpus (seed " << settings.seed << "):\n";
+    for (auto const &kind : corpus) {
+        for (auto const &draw : kind.draws) {
+            std::cout << "  " << std::setw(10) << std::left << kind.name << std::right;
+            for (int n : draw.numbers) std::cout << std::setw(4) << n;
+            std::cout << "  -> " << draw.target << '\n';
+        }
+    }
+    std::cout << '\n';
+
+    std::vector<Candidate> const engines{
+        {"raw", {Engine::raw, 1}, true},
+        {"raw -j" + std::to_string(settings.threads), {Engine::raw, settings.threads}, true},
+        {"shared", {Engine::shared}, true},
+        {"values", {Engine::values, settings.threads}, false},
+        {"bitset", {Engine::bitset, settings.threads}, false},
+    };
+
+    std::cout << std::setw(11) << "kind" << std::setw(10) << "engine"
+              << std::setw(11) << "p50 [ms]" << std::setw(11) << "p90 [ms]"
+              << std::setw(11) << "p99 [ms]" << std::setw(12) << "Mnodes/s"
+              << std::setw(12) << "allocs" << std::setw(13) << "peak [KiB]" << '\n';
+
+    std::vector<Result> results;
+    for (auto const &kind : corpus) {
+        for (auto const &engine : engines) {
+            auto const &result = results.emplace_back(measure(kind, engine, settings.runs));
+
+            std::cout << std::setw(11) << result.kind << std::setw(10) << result.engine
+                      << std::fixed << std::setprecision(2)
+                      << std::setw(11) << result.p50
+                      << std::setw(11) << result.p90
+                      << std::setw(11) << result.p99;
+            if (engine.tree) {
+                std::cout << std::setw(12) << result.mnodesPerSecond;
+            }
+            else {
+                std::cout << std::setw(12) << "-";
+            }
+            std::cout << std::setw(12) << result.allocations
+                      << std::setw(13) << std::setprecision(1)
+                      << static_cast<double>(result.peak) / 1024.0 << '\n';
+        }
+    }
+
+    if (not writePath.empty()) {
+        std::ofstream file(writePath);
+        writeBaseline(file, settings, results);
+    }
+
+    if (not baselinePath.empty()) {
+        std::cout << '\n';
+        std::size_t const regressions = compare(baseline, results);
+        if (regressions != 0) {
+            std::cout << regressions << " regressions (tolerance " << baseline.tolerance << ")\n";
+            return 1;
+        }
+        std::cout << "no regressions (tolerance " << baseline.tolerance << ")\n";
+    }
+}
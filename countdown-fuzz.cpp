@@ -0,0 +1,534 @@
+/*
+ * Check that all engines agree with the reference search.
+ *
+ * The reference is what numbers prints: the recursive raw pointer search on one thread
+ * with the solutions sorted and duplicates removed. Random draws of up to six numbers
+ * from the pools of the show are solved by the reference and by every other way to
+ * search, and their solution sets must be the same. The value engines only tell
+ * whether the target can be made, that must agree with the reference finding anything.
+ * Counting without enumerating must give the number of solutions of the reference.
+ * The simplest solutions of the best-first search must be solutions of the reference
+ * with the lowest costs among all of them, the top-k collector must keep the shortest.
+ * Iterative deepening must find exactly the solutions with the fewest operations, and
+ * the must-use-all search exactly the ones that use every number, and with fewer
+ * numbers asked for exactly the ones that use that many. The extended
+ * operators must find the solutions of the standard ones plus others, and each of
+ * those is evaluated again by a parser of its own that knows the rules of the game.
+ * The bitset engine drops intermediate results above its cap, so it may miss targets
+ * but must never find one that the reference does not.
+ *
+ * On a mismatch, the draw is shrunk by dropping numbers and making numbers and target
+ * smaller as long as the mismatch stays, and the smallest draw is printed.
+ * Usage: countdown-fuzz [--iterations N] [--seed S] [-j threads]
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <random>
+#include <string_view>
+#include <thread>
+
+#include "best-first.hpp"
+#include "countdown.hpp"
+#include "draws.hpp"
+#include "raw-engine.hpp"
+#include "shared-engine.hpp"
+#include "top-k.hpp"
+
+using namespace countdown;
+
+struct Draw
+{
+    std::vector<int> numbers;
+    int target;
+};
+
+std::ostream &operator<<(std::ostream &os, Draw const &draw)
+{
+    for (int n : draw.numbers) os << n << ' ';
+    return os << "-> " << draw.target;
+}
+
+// sorted and without duplicates, so that sets can be compared
+std::vector<std::string> canonical(std::vector<std::string> solutions)
+{
+    std::sort(std::begin(solutions), std::end(solutions));
+    solutions.erase(std::unique(std::begin(solutions), std::end(solutions)),
+                    std::end(solutions));
+    return solutions;
+}
+
+std::vector<std::string> reference(Draw const &draw)
+{
+    auto const numberNodes = raw::toNodes(draw.numbers);
+    return canonical(raw::solve(raw::toPointers(numberNodes), draw.target));
+}
+
+// A solution string read back without the engines: the value, the numbers used, and
+// the cost of the best-first search with the default CostModel.
+struct Expression
+{
+    long long value;
+    std::vector<int> numbers;
+    int cost = 0;
+};
+
+// Read one fully parenthesized expression like "((9 + 5) ^ 2)" from the front of s,
+// checking the rules of the game on the way: every value a positive int, no remainder
+// in divisions, results of ^ that fit into an int, and | only of two numbers.
+// Nothing if the text is malformed or breaks a rule.
+std::optional<Expression> parse(std::string_view &s)
+{
+    if (s.empty()) return std::nullopt;
+    if (s.front() != '(') {
+        long long value = 0;
+        std::size_t i = 0;
+        for (; i < std::size(s) and std::isdigit(static_cast<unsigned char>(s[i])); ++i) {
+            value = value * 10 + (s[i] - '0');
+            if (value > std::numeric_limits<int>::max()) return std::nullopt;
+        }
+        if (i == 0 or value == 0) return std::nullopt;
+        s.remove_prefix(i);
+        return Expression{value, {static_cast<int>(value)}};
+    }
+
+    s.remove_prefix(1);
+    bool const leftNumber = not s.empty() and s.front() != '(';
+    auto left = parse(s);
+    if (not left or std::size(s) < 3 or s[0] != ' ' or s[2] != ' ') return std::nullopt;
+    char const op = s[1];
+    s.remove_prefix(3);
+    bool const rightNumber = not s.empty() and s.front() != '(';
+    auto right = parse(s);
+    if (not right or s.empty() or s.front() != ')') return std::nullopt;
+    s.remove_prefix(1);
+
+    long long const a = left->value, b = right->value;
+    long long value = 0;
+    switch (op) {
+    case '+': value = a + b; break;
+    case '-': value = a - b; break;
+    case '*': value = a * b; break;
+    case '/':
+        if (a % b != 0) return std::nullopt;
+        value = a / b;
+        break;
+    case '^':
+        value = 1;
+        for (long long i = 0; i < b and value <= std::numeric_limits<int>::max(); ++i) value *= a;
+        break;
+    case '|':
+        if (not leftNumber or not rightNumber) return std::nullopt;
+        value = std::stoll(std::to_string(a) + std::to_string(b));
+        break;
+    default:
+        return std::nullopt;
+    }
+    if (value < 1 or value > std::numeric_limits<int>::max()) return std::nullopt;
+
+    // like best-first.hpp: operation + digit * (digits of the result) + division
+    CostModel const model;
+    left->cost += right->cost + model.operation
+        + model.digit * static_cast<int>(std::size(std::to_string(value)))
+        + (op == '/' ? model.division : 0);
+    left->value = value;
+    left->numbers.insert(std::end(left->numbers), std::begin(right->numbers),
+                         std::end(right->numbers));
+    return left;
+}
+
+// Nothing if solution is a valid expression for target out of the numbers of draw,
+// otherwise what is wrong with it.
+std::optional<std::string> notASolution(Draw const &draw, std::string const &solution)
+{
+    std::string_view rest = solution;
+    auto const expression = parse(rest);
+    if (not expression or not rest.empty()) return "cannot evaluate " + solution;
+    if (expression->value != draw.target) {
+        return solution + " makes " + std::to_string(expression->value);
+    }
+    auto used = expression->numbers;
+    auto available = draw.numbers;
+    std::sort(std::begin(used), std::end(used));
+    std::sort(std::begin(available), std::end(available));
+    if (not std::includes(std::begin(available), std::end(available),
+                          std::begin(used), std::end(used))) {
+        return solution + " uses numbers that are not in the draw";
+    }
+    return std::nullopt;
+}
+
+// What a candidate found, either solutions or only whether the target is reachable.
+struct Outcome
+{
+    std::vector<std::string> solutions;
+    bool reachable = false;
+    std::size_t count = 0;
+    // how many numbers the solutions must use, 0 for any
+    std::size_t use = 0;
+};
+
+struct Candidate
+{
+    std::string name;
+    std::function<Outcome(Draw const &)> run;
+    // Compare to the reference, return a description of the difference or nothing.
+    std::function<std::optional<std::string>(Draw const &, std::vector<std::string> const &,
+                                             Outcome const &)> check;
+};
+
+std::optional<std::string> sameSolutions(Draw const &,
+                                         std::vector<std::string> const &expected,
+                                         Outcome const &outcome)
+{
+    if (outcome.solutions == expected) return std::nullopt;
+
+    std::vector<std::string> missing, extra;
+    std::set_difference(std::begin(expected), std::end(expected),
+                        std::begin(outcome.solutions), std::end(outcome.solutions),
+                        std::back_inserter(missing));
+    std::set_difference(std::begin(outcome.solutions), std::end(outcome.solutions),
+                        std::begin(expected), std::end(expected),
+                        std::back_inserter(extra));
+    std::string what = std::to_string(std::size(missing)) + " missing, "
+        + std::to_string(std::size(extra)) + " extra";
+    if (not std::empty(missing)) what += ", e.g. missing " + missing.front();
+    if (not std::empty(extra)) what += ", e.g. extra " + extra.front();
+    return what;
+}
+
+std::optional<std::string> sameReachable(Draw const &,
+                                         std::vector<std::string> const &expected,
+                                         Outcome const &outcome)
+{
+    if (outcome.reachable == not std::empty(expected)) return std::nullopt;
+    return outcome.reachable ? "reachable but the reference finds nothing"
+                             : "unreachable but the reference finds solutions";
+}
+
+std::optional<std::string> sameCount(Draw const &,
+                                     std::vector<std::string> const &expected,
+                                     Outcome const &outcome)
+{
+    if (outcome.count == std::size(expected)) return std::nullopt;
+    return "counted " + std::to_string(outcome.count) + " instead of "
+        + std::to_string(std::size(expected));
+}
+
+// how many solutions the engines that rank them are asked for
+constexpr std::size_t bestK = 5;
+
+// cost of a solution of the reference, see parse()
+int cost(std::string const &solution)
+{
+    std::string_view rest = solution;
+    return parse(rest)->cost;
+}
+
+// The simplest solutions must be solutions, there must be as many as requested, and
+// their costs must be the lowest ones over all solutions of the reference.
+std::optional<std::string> someSolutions(Draw const &,
+                                         std::vector<std::string> const &expected,
+                                         Outcome const &outcome)
+{
+    for (auto const &solution : outcome.solutions) {
+        if (not std::binary_search(std::begin(expected), std::end(expected), solution)) {
+            return "not a solution: " + solution;
+        }
+    }
+    if (std::size(outcome.solutions) != std::min(bestK, std::size(expected))) {
+        return "found " + std::to_string(std::size(outcome.solutions)) + " of "
+            + std::to_string(std::min(bestK, std::size(expected)));
+    }
+
+    std::vector<int> lowest, found;
+    for (auto const &solution : expected) lowest.push_back(cost(solution));
+    for (auto const &solution : outcome.solutions) found.push_back(cost(solution));
+    std::sort(std::begin(lowest), std::end(lowest));
+    std::sort(std::begin(found), std::end(found));
+    lowest.resize(std::size(found));
+    if (found != lowest) {
+        return "costs up to " + std::to_string(found.back()) + " instead of "
+            + std::to_string(lowest.back());
+    }
+    return std::nullopt;
+}
+
+// the shortest solutions of the reference, shortest first, ties by expression
+std::optional<std::string> shortestSolutions(Draw const &,
+                                             std::vector<std::string> const &expected,
+                                             Outcome const &outcome)
+{
+    auto shortest = expected;
+    std::stable_sort(std::begin(shortest), std::end(shortest),
+                     [](std::string const &l, std::string const &r) {
+                         return std::size(l) < std::size(r);
+                     });
+    if (std::size(shortest) > bestK) shortest.resize(bestK);
+    if (outcome.solutions == shortest) return std::nullopt;
+    return "not the " + std::to_string(std::size(shortest)) + " shortest solutions";
+}
+
+// the solutions of the reference with the fewest operations
+std::optional<std::string> fewestOperations(Draw const &draw,
+                                            std::vector<std::string> const &expected,
+                                            Outcome const &outcome)
+{
+    // every operation adds one pair of parentheses
+    auto const operations = [](std::string const &s) {
+        return std::count(std::begin(s), std::end(s), '(');
+    };
+    std::vector<std::string> fewest;
+    for (auto const &solution : expected) {
+        if (not std::empty(fewest) and operations(solution) > operations(fewest.front())) continue;
+        if (not std::empty(fewest) and operations(solution) < operations(fewest.front())) {
+            fewest.clear();
+        }
+        fewest.push_back(solution);
+    }
+    return sameSolutions(draw, fewest, outcome);
+}
+
+// the solutions of the reference that use exactly outcome.use numbers
+std::optional<std::string> sameNumbersUsed(Draw const &draw,
+                                           std::vector<std::string> const &expected,
+                                           Outcome const &outcome)
+{
+    std::vector<std::string> matching;
+    for (auto const &solution : expected) {
+        // every operation adds one pair of parentheses and one number
+        auto const operations = std::count(std::begin(solution), std::end(solution), '(');
+        if (static_cast<std::size_t>(operations) + 1 == outcome.use) {
+            matching.push_back(solution);
+        }
+    }
+    return sameSolutions(draw, matching, outcome);
+}
+
+// More operators find the same solutions and more, and every one of those must really
+// make the target, read back by parse() instead of the engine that made it.
+std::optional<std::string> allSolutions(Draw const &draw,
+                                        std::vector<std::string> const &expected,
+                                        Outcome const &outcome)
+{
+    std::vector<std::string> standard;
+    for (auto const &solution : outcome.solutions) {
+        if (auto const what = notASolution(draw, solution)) return what;
+        if (solution.find_first_of("^|") == std::string::npos) standard.push_back(solution);
+    }
+    // with only the standard operators, it is the same search
+    return sameSolutions(draw, expected, Outcome{standard});
+}
+
+std::optional<std::string> noFalseReachable(Draw const &,
+                                            std::vector<std::string> const &expected,
+                                            Outcome const &outcome)
+{
+    if (not outcome.reachable or not std::empty(expected)) return std::nullopt;
+    return "reachable but the reference finds nothing";
+}
+
+std::vector<Candidate> candidates(unsigned const threads)
+{
+    return {
+        {"shared", [](Draw const &draw) {
+             std::vector<std::string> solutions;
+             for (auto const &node : shared::solve(shared::toNodes(draw.numbers), draw.target)) {
+                 solutions.push_back(node->str());
+             }
+             return Outcome{canonical(solutions)};
+         }, sameSolutions},
+        {"raw -j" + std::to_string(threads), [threads](Draw const &draw) {
+             auto const numberNodes = raw::toNodes(draw.numbers);
+             return Outcome{canonical(raw::solveParallel(raw::toPointers(numberNodes),
+                                                         draw.target, threads))};
+         }, sameSolutions},
+        {"lazy", [](Draw const &draw) {
+             auto const numberNodes = raw::toNodes(draw.numbers);
+             std::vector<std::string> solutions;
+             for (auto const &solution : raw::lazySolve(raw::toPointers(numberNodes), draw.target)) {
+                 solutions.push_back(solution);
+             }
+             return Outcome{canonical(solutions)};
+         }, sameSolutions},
+        {"stream", [](Draw const &draw) {
+             auto const numberNodes = raw::toNodes(draw.numbers);
+             std::vector<std::string> solutions;
+             raw::forEachSolution(raw::toPointers(numberNodes), draw.target,
+                                  [&](raw::Node &node) { solutions.push_back(raw::to_string(node)); });
+             return Outcome{canonical(solutions)};
+         }, sameSolutions},
+        {"library", [threads](Draw const &draw) {
+             return Outcome{solve(draw.numbers, draw.target, {Engine::automatic, threads})};
+         }, sameSolutions},
+        {"simplest", [](Draw const &draw) {
+             std::vector<std::string> solutions;
+             for (auto const &solution : simplestSolutions(draw.numbers, draw.target, bestK)) {
+                 solutions.push_back(solution.expression);
+             }
+             return Outcome{canonical(solutions)};
+         }, someSolutions},
+        {"top", [](Draw const &draw) {
+             auto const numberNodes = raw::toNodes(draw.numbers);
+             std::vector<std::string> solutions;
+             for (auto const &solution : raw::topK(raw::toPointers(numberNodes), draw.target,
+                                                   bestK)) {
+                 solutions.push_back(solution.expression);
+             }
+             return Outcome{solutions};
+         }, shortestSolutions},
+        {"shallowest", [](Draw const &draw) {
+             auto const numberNodes = raw::toNodes(draw.numbers);
+             return Outcome{raw::solveShallowest(raw::toPointers(numberNodes), draw.target)
+                                .solutions};
+         }, fewestOperations},
+        {"extended", [](Draw const &draw) {
+             auto const numberNodes = raw::toNodes(draw.numbers);
+             return Outcome{canonical(raw::solveWith<raw::Extended>(raw::toPointers(numberNodes),
+                                                                    draw.target))};
+         }, allSolutions},
+        {"use-all", [](Draw const &draw) {
+             Options options;
+             options.use = std::size(draw.numbers);
+             return Outcome{solve(draw.numbers, draw.target, options), false, 0, options.use};
+         }, sameNumbersUsed},
+        {"use-some", [](Draw const &draw) {
+             // k in [2, n-1] taken from the target, random over the draws and the
+             // same when a failing draw is replayed
+             auto const n = std::size(draw.numbers);
+             Options options;
+             options.use = n > 2 ? 2 + static_cast<std::size_t>(draw.target) % (n - 2) : n;
+             return Outcome{solve(draw.numbers, draw.target, options), false, 0, options.use};
+         }, sameNumbersUsed},
+        {"count", [](Draw const &draw) {
+             return Outcome{{}, false, count(draw.numbers, draw.target)};
+         }, sameCount},
+        {"values", [threads](Draw const &draw) {
+             return Outcome{{}, nearest(draw.numbers, draw.target, {Engine::values, threads})
+                                    == draw.target};
+         }, sameReachable},
+        {"bitset", [threads](Draw const &draw) {
+             return Outcome{{}, nearest(draw.numbers, draw.target, {Engine::bitset, threads})
+                                    == draw.target};
+         }, noFalseReachable},
+    };
+}
+
+std::optional<std::string> mismatch(Candidate const &candidate, Draw const &draw)
+{
+    return candidate.check(draw, reference(draw), candidate.run(draw));
+}
+
+// Smaller draws that might still show the same mismatch, simplest first.
+std::vector<Draw> simpler(Draw const &draw)
+{
+    std::vector<Draw> smaller;
+    if (std::size(draw.numbers) > 2) {
+        for (std::size_t i = 0; i < std::size(draw.numbers); ++i) {
+            Draw without = draw;
+            without.numbers.erase(std::begin(without.numbers) + static_cast<std::ptrdiff_t>(i));
+            smaller.push_back(without);
+        }
+    }
+    for (std::size_t i = 0; i < std::size(draw.numbers); ++i) {
+        for (int const value : {1, draw.numbers[i] / 2, draw.numbers[i] - 1}) {
+            if (value < 1 or value >= draw.numbers[i]) continue;
+            Draw lower = draw;
+            lower.numbers[i] = value;
+            smaller.push_back(lower);
+        }
+    }
+    for (int const target : {1, draw.target / 2, draw.target - 1}) {
+        if (target < 1 or target >= draw.target) continue;
+        smaller.push_back({draw.numbers, target});
+    }
+    return smaller;
+}
+
+// Take the first simpler draw that still fails until there is none.
+Draw shrink(Candidate const &candidate, Draw draw)
+{
+    for (bool progress = true; progress; ) {
+        progress = false;
+        for (auto const &next : simpler(draw)) {
+            if (mismatch(candidate, next)) {
+                draw = next;
+                progress = true;
+                break;
+            }
+        }
+    }
+    return draw;
+}
+
+// Up to six numbers like in the show, so no intermediate result overflows int.
+// Half of the targets are picked from the reachable values so that there is something
+// to compare.
+Draw fuzzDraw(std::mt19937 &rng)
+{
+    Draw draw;
+    draw.numbers = randomDraw(rng, uniform(rng, 2, 6));
+
+    draw.target = uniform(rng, 1, 999);
+    if (uniform(rng, 0, 1) == 0) {
+        auto const values = reachable(draw.numbers);
+        if (not std::empty(values)) {
+            draw.target = values[static_cast<std::size_t>(
+                uniform(rng, 0, static_cast<int>(std::size(values)) - 1))];
+        }
+    }
+    return draw;
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t iterations = 200;
+    unsigned seed = std::random_device{}();
+    unsigned threads = std::max(2u, std::thread::hardware_concurrency());
+    for (int i = 1; i < argc; ++i) {
+        std::string const arg = argv[i];
+        if (arg == "--iterations" and i+1 < argc) {
+            iterations = std::stoul(argv[++i]);
+        }
+        else if (arg == "--seed" and i+1 < argc) {
+            seed = static_cast<unsigned>(std::stoul(argv[++i]));
+        }
+        else if (arg == "-j" and i+1 < argc) {
+            threads = std::max(1u, static_cast<unsigned>(std::stoul(argv[++i])));
+        }
+        else {
+            std::cerr << "usage: countdown-fuzz [--iterations N] [--seed S] [-j threads]\n";
+            return 1;
+        }
+    }
+
+    std::cout << "seed " << seed << '\n';
+    std::mt19937 rng(seed);
+    auto const engines = candidates(threads);
+
+    std::size_t failures = 0;
+    for (std::size_t iteration = 0; iteration < iterations; ++iteration) {
+        Draw const draw = fuzzDraw(rng);
+        auto const expected = reference(draw);
+        for (auto const &candidate : engines) {
+            auto const what = candidate.check(draw, expected, candidate.run(draw));
+            if (not what) continue;
+
+            ++failures;
+            Draw const minimal = shrink(candidate, draw);
+            std::cout << "MISMATCH " << candidate.name << " on " << draw << ": " << *what << '\n'
+                      << "  smallest draw: " << minimal << ": " << *mismatch(candidate, minimal)
+                      << '\n';
+        }
+    }
+
+    std::cout << iterations << " draws, " << failures << " mismatches\n";
+    return failures == 0 ? 0 : 1;
+}
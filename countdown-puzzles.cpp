@@ -0,0 +1,161 @@
+/*
+ * Generate puzzles of the numbers game from the TV show countdown.
+ *
+ * Draws are picked like in the show: six cards, up to four out of 25, 50, 75, 100 and
+ * the rest out of two each of 1 to 10. Instead of solving every draw for a random
+ * target and trying again if that did not fit, a single pass of the counting DP gives
+ * the number of distinct solutions for every value the draw can make (see
+ * solution-count.hpp). The target is picked out of the values between 101 and 999 with
+ * a number of solutions in the requested band, so every puzzle is solvable and about
+ * as hard as asked for. A draw without such a value is replaced by another one, up to
+ * --max-draws times per puzzle (default 200), after that the band is given up on as
+ * too narrow and the program fails.
+ *
+ * Puzzle i only depends on the seed and i, so the output does not change with the
+ * number of threads.
+ *
+ * Usage: countdown-puzzles [-n puzzles] [-j threads] [--seed S] [--max-draws N]
+ *                          [--difficulty easy|medium|hard | --solutions MIN MAX]
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <thread>
+
+#include "draws.hpp"
+#include "solution-count.hpp"
+
+using namespace countdown;
+
+struct Puzzle
+{
+    std::vector<int> numbers;
+    int target;
+    // number of distinct solutions
+    std::uint64_t solutions;
+};
+
+// accepted numbers of distinct solutions, both inclusive
+struct Band
+{
+    std::uint64_t least;
+    std::uint64_t most;
+};
+
+// nothing if none of maxDraws draws had a value in the band
+std::optional<Puzzle> makePuzzle(unsigned const seed, std::size_t const index, Band const band,
+                                 std::size_t const maxDraws)
+{
+    std::seed_seq seq{seed, static_cast<unsigned>(index), static_cast<unsigned>(index >> 32)};
+    std::mt19937 rng(seq);
+
+    constexpr int lowest = 101, highest = 999;
+    std::vector<std::pair<int, std::uint64_t>> candidates;
+    for (std::size_t tries = 0; tries < maxDraws; ++tries) {
+        auto draw = randomDraw(rng);
+        candidates.clear();
+        for (auto const &[value, count] : solutionCounts(draw, lowest, highest)) {
+            if (count >= band.least and count <= band.most) candidates.emplace_back(value, count);
+        }
+        if (std::empty(candidates)) continue;
+
+        auto const [target, count] = candidates[static_cast<std::size_t>(
+            uniform(rng, 0, static_cast<int>(std::size(candidates)) - 1))];
+        return Puzzle{std::move(draw), target, count};
+    }
+    return std::nullopt;
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t n = 10;
+    unsigned threads = 0;
+    unsigned seed = std::random_device{}();
+    Band band{1, 9};
+    std::size_t maxDraws = 200;
+    for (int i = 1; i < argc; ++i) {
+        std::string const arg = argv[i];
+        if (arg == "-n" and i+1 < argc) {
+            n = std::stoul(argv[++i]);
+        }
+        else if (arg == "-j" and i+1 < argc) {
+            threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--seed" and i+1 < argc) {
+            seed = static_cast<unsigned>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--max-draws" and i+1 < argc) {
+            maxDraws = std::stoul(argv[++i]);
+        }
+        else if (arg == "--difficulty" and i+1 < argc) {
+            std::string const name = argv[++i];
+            if (name == "easy") band = {100, UINT64_MAX};
+            else if (name == "medium") band = {10, 99};
+            else if (name == "hard") band = {1, 9};
+            else {
+                std::cerr << "unknown difficulty " << name << '\n';
+                return 1;
+            }
+        }
+        else if (arg == "--solutions" and i+2 < argc) {
+            band.least = std::max(1ul, std::stoul(argv[++i]));
+            band.most = std::stoul(argv[++i]);
+        }
+        else {
+            std::cerr << "usage: countdown-puzzles [-n puzzles] [-j threads] [--seed S] [--max-draws N]\n"
+                         "                         [--difficulty easy|medium|hard | --solutions MIN MAX]\n";
+            return 1;
+        }
+    }
+    if (band.least > band.most) {
+        std::cerr << "empty band, MIN is above MAX\n";
+        return 1;
+    }
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    auto startTime = std::chrono::steady_clock::now();
+    std::vector<Puzzle> puzzles(n);
+    std::atomic<std::size_t> next{0};
+    std::atomic<bool> failed{false};
+    auto const work = [&] {
+        while (not failed.load(std::memory_order_relaxed)) {
+            std::size_t const i = next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= n) break;
+            if (auto puzzle = makePuzzle(seed, i, band, maxDraws)) puzzles[i] = std::move(*puzzle);
+            else failed = true;
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) {
+        pool.emplace_back(work);
+    }
+    work();
+    for (auto &thread : pool) {
+        thread.join();
+    }
+    auto endTime = std::chrono::steady_clock::now();
+    if (failed) {
+        std::cerr << "no value with " << band.least << " to " << band.most << " solutions in "
+                  << maxDraws << " draws, try a wider band or more --max-draws\n";
+        return 1;
+    }
+
+    for (auto const &puzzle : puzzles) {
+        std::cout << puzzle.target << ':';
+        for (int const number : puzzle.numbers)
+            std::cout << ' ' << number;
+        std::cout << "  [" << puzzle.solutions << " solutions]\n";
+    }
+
+    auto const us = std::chrono::duration_cast<std::chrono::microseconds>(endTime-startTime).count();
+    std::cerr << "seed " << seed << ", " << n << " puzzles in " << us / 1000 << "ms on "
+              << threads << " threads (" << (us == 0 ? 0 : n * 1'000'000 / static_cast<std::size_t>(us))
+              << " per second)\n";
+}
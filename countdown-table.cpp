@@ -0,0 +1,112 @@
+/*
+ * Solve the numbers game from the TV show countdown.
+ *
+ * Precompute which targets are reachable for every draw of the show and look them up
+ * in the memory-mapped table, see reachability-table.hpp.
+ *
+ * Usage: countdown-table build [-j threads] [--cap N] path
+ *        countdown-table query path target numbers...
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+#include "reachability-table.hpp"
+
+using namespace countdown;
+
+// All distinct draws of the show: six cards out of 25, 50, 75, 100 and two each of 1 to 10.
+std::vector<std::vector<int>> showDraws()
+{
+    std::vector<std::pair<int, int>> const cards{
+        {25, 1}, {50, 1}, {75, 1}, {100, 1},
+        {1, 2}, {2, 2}, {3, 2}, {4, 2}, {5, 2}, {6, 2}, {7, 2}, {8, 2}, {9, 2}, {10, 2}};
+
+    std::vector<std::vector<int>> draws;
+    // how often each card is in the draw
+    std::vector<int> counts(std::size(cards), 0);
+    auto const add = [&](auto const &self, std::size_t const card, int const left) -> void {
+        if (left == 0) {
+            std::vector<int> draw;
+            for (std::size_t c = 0; c < std::size(cards); ++c) {
+                draw.insert(std::end(draw), static_cast<std::size_t>(counts[c]), cards[c].first);
+            }
+            draws.push_back(std::move(draw));
+            return;
+        }
+        if (card == std::size(cards)) return;
+        for (int n = 0; n <= std::min(cards[card].second, left); ++n) {
+            counts[card] = n;
+            self(self, card+1, left-n);
+        }
+        counts[card] = 0;
+    };
+    add(add, 0, 6);
+    return draws;
+}
+
+int main(int argc, char *argv[])
+{
+    try {
+        std::vector<std::string> args(argv+1, argv+argc);
+        if (not args.empty() and args[0] == "build") {
+            unsigned threads = 0;
+            int cap = 1000;
+            std::string path;
+            for (std::size_t i = 1; i < std::size(args); ++i) {
+                if (args[i] == "-j" and i+1 < std::size(args)) {
+                    threads = static_cast<unsigned>(std::stoul(args[++i]));
+                }
+                else if (args[i] == "--cap" and i+1 < std::size(args)) {
+                    cap = std::stoi(args[++i]);
+                }
+                else {
+                    path = args[i];
+                }
+            }
+            if (not path.empty()) {
+                auto const draws = showDraws();
+                auto const start = std::chrono::steady_clock::now();
+                writeReachabilityTable(path, draws, cap, threads);
+                auto const end = std::chrono::steady_clock::now();
+                std::cout << "Wrote " << std::size(draws) << " draws to " << path << " in "
+                          << std::chrono::duration_cast<std::chrono::milliseconds>(end-start).count()
+                          << "ms\n";
+                return 0;
+            }
+        }
+        else if (std::size(args) >= 4 and args[0] == "query") {
+            auto const start = std::chrono::steady_clock::now();
+            ReachabilityTable const table{args[1]};
+            int const target = std::stoi(args[2]);
+            std::vector<int> numbers;
+            for (std::size_t i = 3; i < std::size(args); ++i) {
+                numbers.push_back(std::stoi(args[i]));
+            }
+            auto const found = table.reachable(numbers, target);
+            auto const end = std::chrono::steady_clock::now();
+
+            if (not found) {
+                std::cout << "not in the table\n";
+                return 1;
+            }
+            std::cout << target << (*found ? " is reachable\n" : " is not reachable\n");
+            std::cout << "Time to lookup: "
+                      << std::chrono::duration_cast<std::chrono::microseconds>(end-start).count()
+                      << "us\n";
+            return 0;
+        }
+    }
+    catch (std::exception const &e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+
+    std::cerr << "Usage: countdown-table build [-j threads] [--cap N] path\n"
+              << "       countdown-table query path target numbers...\n";
+    return 1;
+}
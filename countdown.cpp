@@ -0,0 +1,188 @@
+#include "countdown.hpp"
+#include "combine.hpp"
+#include "raw-engine.hpp"
+#include "shared-engine.hpp"
+#include "solution-count.hpp"
+#include "subset-dp.hpp"
+#include "subset-levels.hpp"
+#include "trace.hpp"
+#include "value-bitset.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace countdown {
+
+namespace {
+    Engine expressionEngine(Engine const engine)
+    {
+        switch (engine) {
+        case Engine::automatic:
+        case Engine::raw:
+            return Engine::raw;
+        case Engine::shared:
+            return Engine::shared;
+        default:
+            throw std::invalid_argument("engine cannot find expressions");
+        }
+    }
+
+    Engine valueEngine(Engine const engine)
+    {
+        switch (engine) {
+        case Engine::automatic:
+        case Engine::values:
+            return Engine::values;
+        case Engine::bitset:
+            return Engine::bitset;
+        default:
+            throw std::invalid_argument("engine cannot find values");
+        }
+    }
+
+    int valuesLimit(Options const &options)
+    {
+        return options.limit == 0 ? maxLimit : std::min(options.limit, maxLimit);
+    }
+
+    int bitsetCap(Options const &options)
+    {
+        if (options.limit < 0 or options.limit >= maxCap) {
+            throw std::invalid_argument("limit out of range for the bitset engine");
+        }
+        return options.limit == 0 ? defaultCap : options.limit + 1;
+    }
+
+    void sortUnique(std::vector<std::string> &solutions)
+    {
+        std::sort(std::begin(solutions), std::end(solutions));
+        solutions.erase(std::unique(std::begin(solutions), std::end(solutions)),
+                        std::end(solutions));
+    }
+}
+
+std::vector<std::string> solve(std::vector<int> const &numbers, int const target,
+                               Options const &options)
+{
+    trace::Scope search("search");
+    std::vector<std::string> solutions;
+    auto const hitsBefore = options.stats ? options.stats->hits : 0;
+    if (options.use != 0) {
+        if (expressionEngine(options.engine) != Engine::raw) {
+            throw std::invalid_argument("engine cannot restrict the numbers used");
+        }
+        auto const numberNodes = raw::toNodes(numbers);
+        auto const workingArray = raw::toPointers(numberNodes);
+        solutions = options.stats
+            ? raw::solveUsing(workingArray, target, options.use, *options.stats)
+            : raw::solveUsing(workingArray, target, options.use);
+    }
+    else if (expressionEngine(options.engine) == Engine::shared) {
+        auto const numberNodes = shared::toNodes(numbers);
+        auto const nodes = options.stats
+            ? shared::solve(numberNodes, target, *options.stats)
+            : shared::solve(numberNodes, target);
+        for (auto const &node : nodes) {
+            solutions.push_back(node->str());
+        }
+    }
+    else {
+        auto const numberNodes = raw::toNodes(numbers);
+        auto const workingArray = raw::toPointers(numberNodes);
+        unsigned const threads = levelWorkers(options.threads);
+        if (options.stats) {
+            solutions = threads == 1
+                ? raw::solve(workingArray, target, *options.stats)
+                : raw::solveParallel(workingArray, target, threads, *options.stats);
+        }
+        else {
+            solutions = threads == 1
+                ? raw::solve(workingArray, target)
+                : raw::solveParallel(workingArray, target, threads);
+        }
+    }
+
+    search.close();
+
+    trace::Scope const dedup("dedup");
+    auto const found = std::size(solutions);
+    sortUnique(solutions);
+    if (options.stats and options.use != 0) {
+        // the hits with other numbers used were dropped without being duplicates
+        options.stats->duplicates += found - std::size(solutions);
+    }
+    else if (options.stats) {
+        // the parallel search already dropped some of them on the way
+        options.stats->duplicates += options.stats->hits - hitsBefore - std::size(solutions);
+    }
+    return solutions;
+}
+
+Anytime solveWithin(std::vector<int> const &numbers, int const target,
+                    std::chrono::nanoseconds const budget)
+{
+    auto const deadline = std::chrono::steady_clock::now() + budget;
+    auto const numberNodes = raw::toNodes(numbers);
+    auto result = raw::solveUntil(raw::toPointers(numberNodes), target, deadline);
+    return {std::move(result.solutions), std::move(result.closest), result.closestValue,
+            result.complete};
+}
+
+std::size_t count(std::vector<int> const &numbers, int const target,
+                  Options const &options)
+{
+    if (options.use != 0) {
+        Options raw = options;
+        raw.engine = Engine::raw;
+        return std::size(solve(numbers, target, raw));
+    }
+
+    switch (options.engine) {
+    case Engine::raw:
+    case Engine::shared:
+        return std::size(solve(numbers, target, options));
+    default:
+        return countSolutions(numbers, target, valuesLimit(options));
+    }
+}
+
+int nearest(std::vector<int> const &numbers, int const target, Options const &options)
+{
+    if (valueEngine(options.engine) == Engine::bitset) {
+        auto const all = reachableSet(subsetBitsets(numbers, bitsetCap(options), options.threads));
+        // walk outwards from target within the bitset, below first to prefer the
+        // smaller value, nothing at or above the cap can be set
+        int const top = all.cap() - 1;
+        int const start = std::min(target, top);
+        for (int distance = 0; distance <= top; ++distance) {
+            if (start - distance >= 0 and all.test(start - distance)) return start - distance;
+            if (start + distance <= top and all.test(start + distance)) {
+                return start + distance;
+            }
+        }
+        return 0;
+    }
+
+    return nearest(subsetValues(numbers, valuesLimit(options), options.threads), target);
+}
+
+std::vector<int> reachable(std::vector<int> const &numbers, Options const &options)
+{
+    std::vector<int> all;
+    if (valueEngine(options.engine) == Engine::bitset) {
+        reachableSet(subsetBitsets(numbers, bitsetCap(options), options.threads))
+            .forEach([&](int const value) { all.push_back(value); });
+        return all;
+    }
+
+    auto const values = subsetValues(numbers, valuesLimit(options), options.threads);
+    for (unsigned set = 1; set < std::size(values); ++set) {
+        if ((set & (set-1)) == 0) continue;  // single number
+        all.insert(std::end(all), std::begin(values[set]), std::end(values[set]));
+    }
+    std::sort(std::begin(all), std::end(all));
+    all.erase(std::unique(std::begin(all), std::end(all)), std::end(all));
+    return all;
+}
+
+}  // namespace countdown
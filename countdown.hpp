@@ -0,0 +1,96 @@
+/*
+ * Solve the numbers game from the TV show countdown.
+ *
+ * This is the interface for using the solvers as a library.
+ * Only positive integers and operations +, -, *, / (no remainder) are allowed
+ * and every number can be used at most once.
+ */
+
+#ifndef COUNTDOWN_COUNTDOWN_HPP
+#define COUNTDOWN_COUNTDOWN_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "search-stats.hpp"
+
+namespace countdown {
+
+// How to search.
+enum class Engine
+{
+    // the fastest engine that supports the call
+    automatic,
+    // tree search with raw pointers, finds expressions
+    raw,
+    // tree search with shared pointers, finds expressions
+    shared,
+    // subset DP over lists of values, only finds values
+    values,
+    // subset DP over bitsets of values below a cap, only finds values
+    bitset,
+};
+
+struct Options
+{
+    Engine engine = Engine::automatic;
+    // number of threads, 0 means all hardware threads,
+    // engines that cannot run in parallel ignore it
+    unsigned threads = 1;
+    // largest intermediate value of the value engines, 0 means the engine's default,
+    // the bitset engine keeps a bit per value for every subset and throws
+    // std::invalid_argument for negative limits and limits of maxCap (value-bitset.hpp)
+    // or more
+    int limit = 0;
+    // if set, the tree engines add counters of their search to it, with use set
+    // its hits include those with other numbers used
+    SearchStats *stats = nullptr;
+    // only solutions that use exactly this many numbers, 0 for any,
+    // only the raw engine supports it and it searches on one thread then
+    std::size_t use = 0;
+};
+
+// All distinct solutions for target, sorted.
+// Expressions with the same string representation count as the same.
+// Throws std::invalid_argument if the engine cannot find expressions, or cannot
+// restrict the numbers used if options.use is set.
+std::vector<std::string> solve(std::vector<int> const &numbers, int target,
+                               Options const &options = {});
+
+struct Anytime
+{
+    // the distinct solutions found in time, sorted
+    std::vector<std::string> solutions;
+    // the expression closest to target found in time, a solution if there are any
+    std::string closest;
+    int closestValue = 0;
+    // false if the search ran out of time
+    bool complete = false;
+};
+
+// Search with the raw engine on one thread for at most budget and return the solutions
+// and the closest expression found so far.
+Anytime solveWithin(std::vector<int> const &numbers, int target,
+                    std::chrono::nanoseconds budget);
+
+// The number of distinct solutions, i.e. the size of solve().
+// The tree engines enumerate the solutions, all others count them in a DP over the
+// numbers without making any expressions (see solution-count.hpp), unless options.use
+// is set, which always enumerates them with the raw engine.
+std::size_t count(std::vector<int> const &numbers, int target,
+                  Options const &options = {});
+
+// The value closest to target that can be made with at least one operation.
+// Prefers the smaller value on ties, 0 if nothing can be made.
+// Throws std::invalid_argument if the engine cannot find values.
+int nearest(std::vector<int> const &numbers, int target, Options const &options = {});
+
+// All values that can be made with at least one operation, sorted.
+// Throws std::invalid_argument if the engine cannot find values.
+std::vector<int> reachable(std::vector<int> const &numbers, Options const &options = {});
+
+}  // namespace countdown
+
+#endif  // COUNTDOWN_COUNTDOWN_HPP
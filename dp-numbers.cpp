@@ -0,0 +1,87 @@
+/*
+ * Solve the numbers game from the TV show countdown.
+ *
+ * Find out whether a target number can be reached from a set of numbers
+ * and which reachable number is closest to it.
+ * Only positive integers and operations +, -, *, / (no remainder)
+ * are allowed.
+ *
+ * Computes the values of all subsets of the inputs bottom up instead of building trees.
+ * This is much faster than the tree search but does not show how to get the target.
+ * If only reachability matters, the values below a cap can be stored as bitsets
+ * which is faster still. The number of distinct solutions is counted in a similar DP
+ * over the numbers without making any expressions.
+ */
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <chrono>
+
+#include "combine.hpp"
+#include "solution-count.hpp"
+#include "subset-dp.hpp"
+#include "value-bitset.hpp"
+
+using namespace countdown;
+
+int main()
+{
+    // the number we want to get
+    constexpr int target = 784;
+    // the input numbers
+    constexpr std::array numbers{100, 50, 9, 5, 2, 4};
+
+    std::cout << "Numbers:\n";
+    for (int n : numbers)
+        std::cout << n << "  ";
+    std::cout << "\n\n";
+
+    // solve
+    auto startTimeSol = std::chrono::steady_clock::now();
+    auto const values = subsetValues({std::begin(numbers), std::end(numbers)}, maxLimit, 0);
+    auto const found = reachable(values, target);
+    auto const closest = found ? target : nearest(values, target);
+    auto endTimeSol = std::chrono::steady_clock::now();
+
+    std::size_t total = 0;
+    for (auto const &vals : values)
+        total += std::size(vals);
+
+    if (found)
+        std::cout << target << " is reachable\n";
+    else
+        std::cout << target << " is not reachable, closest is " << closest << '\n';
+    std::cout << "There are " << total << " values over all subsets\n";
+
+    // only reachability with values below the cap, much cheaper
+    auto startTimeReach = std::chrono::steady_clock::now();
+    auto const bitsets = subsetBitsets({std::begin(numbers), std::end(numbers)}, defaultCap, 0);
+    auto const foundBitset = reachable(bitsets, target);
+    auto endTimeReach = std::chrono::steady_clock::now();
+
+    std::cout << target << (foundBitset ? " is" : " is not")
+              << " reachable with values below " << defaultCap << '\n';
+    std::cout << "There are " << reachableSet(bitsets).count() << " reachable values below "
+              << defaultCap << '\n';
+
+    // how many distinct solutions there are, without making them
+    auto startTimeCount = std::chrono::steady_clock::now();
+    auto const nsolutions = countSolutions({std::begin(numbers), std::end(numbers)}, target);
+    auto endTimeCount = std::chrono::steady_clock::now();
+
+    std::cout << "There are " << nsolutions << " 'distinct' solutions\n";
+
+    std::cout << '\n';
+    std::cout << "Combine kernel: " << combineKernel() << '\n';
+    std::cout << "Time to solution: "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(endTimeSol-startTimeSol).count()
+              << "ms\n";
+    std::cout << "Time to reachability: "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(endTimeReach-startTimeReach).count()
+              << "ms\n";
+    std::cout << "Time to count: "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(endTimeCount-startTimeCount).count()
+              << "ms\n";
+}
@@ -0,0 +1,75 @@
+/*
+ * Measure how the subset DP scales with the number of threads.
+ *
+ * Runs the bitset version of the DP for draws of 6, 8 and 10 numbers and the value list
+ * version for 6 and 8 numbers with 1 up to all hardware threads and prints the times
+ * and speedups.
+ * Usage: dp-scaling [max threads]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "subset-dp.hpp"
+#include "value-bitset.hpp"
+
+using namespace countdown;
+
+// best of a few runs in ms, the DP is deterministic so the minimum is the least noisy
+template <typename F>
+double timeMs(F &&f)
+{
+    double best = 0;
+    for (int run = 0; run < 3; ++run) {
+        auto const start = std::chrono::steady_clock::now();
+        f();
+        auto const end = std::chrono::steady_clock::now();
+        double const ms = std::chrono::duration<double, std::milli>(end-start).count();
+        if (run == 0 or ms < best) best = ms;
+    }
+    return best;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned const maxThreads = argc > 1
+        ? static_cast<unsigned>(std::stoul(argv[1]))
+        : std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<std::vector<int>> const draws{
+        {100, 50, 9, 5, 2, 4},
+        {100, 75, 50, 9, 5, 3, 2, 4},
+        {100, 75, 50, 25, 9, 7, 5, 3, 2, 4},
+    };
+    // The value lists of large draws get too big to be useful without a small limit.
+    // Bitsets do not care how dense the values are.
+    constexpr int limit = 10000;
+    constexpr std::size_t maxValuesDraw = 8;
+
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << "\n\n";
+    std::cout << std::setw(8) << "numbers" << std::setw(8) << "engine" << std::setw(9) << "threads"
+              << std::setw(12) << "time [ms]" << std::setw(10) << "speedup" << '\n';
+
+    for (auto const &draw : draws) {
+        for (std::string const engine : {"values", "bitset"}) {
+            if (engine == "values" and std::size(draw) > maxValuesDraw) continue;
+            double base = 0;
+            for (unsigned threads = 1; threads <= maxThreads; ++threads) {
+                double const ms = engine == "values"
+                    ? timeMs([&] { subsetValues(draw, limit, threads); })
+                    : timeMs([&] { subsetBitsets(draw, defaultCap, threads); });
+                if (threads == 1) base = ms;
+
+                std::cout << std::setw(8) << std::size(draw) << std::setw(8) << engine
+                          << std::setw(9) << threads
+                          << std::setw(12) << std::fixed << std::setprecision(1) << ms
+                          << std::setw(10) << std::setprecision(2) << base / ms << '\n';
+            }
+        }
+    }
+}
@@ -0,0 +1,33 @@
+#include "draws.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace countdown {
+
+int uniform(std::mt19937 &rng, int const low, int const high)
+{
+    return low + static_cast<int>(rng() % static_cast<std::uint32_t>(high - low + 1));
+}
+
+std::vector<int> randomDraw(std::mt19937 &rng, int const size)
+{
+    std::vector<int> large{25, 50, 75, 100};
+    std::vector<int> small;
+    for (int n = 1; n <= 10; ++n) {
+        small.push_back(n);
+        small.push_back(n);
+    }
+
+    std::vector<int> draw;
+    int const nLarge = uniform(rng, 0, std::min(4, size));
+    for (int i = 0; i < size; ++i) {
+        auto &pool = i < nLarge ? large : small;
+        auto const pick = std::begin(pool) + uniform(rng, 0, static_cast<int>(std::size(pool)) - 1);
+        draw.push_back(*pick);
+        pool.erase(pick);
+    }
+    return draw;
+}
+
+}  // namespace countdown
@@ -0,0 +1,26 @@
+/*
+ * Random draws like in the TV show countdown, shared by the programs that need many.
+ *
+ * Everything is built on the raw output of std::mt19937, which the standard fixes,
+ * so a seed gives the same draws with any standard library.
+ */
+
+#ifndef COUNTDOWN_DRAWS_HPP
+#define COUNTDOWN_DRAWS_HPP
+
+#include <random>
+#include <vector>
+
+namespace countdown {
+
+// Uniform in [low, high]. std::uniform_int_distribution differs between standard
+// libraries, this does not.
+int uniform(std::mt19937 &rng, int low, int high);
+
+// size numbers (at most 6): a random number of them, at most four, out of 25, 50, 75,
+// 100 and the rest out of two each of 1 to 10, large ones first.
+std::vector<int> randomDraw(std::mt19937 &rng, int size = 6);
+
+}  // namespace countdown
+
+#endif  // COUNTDOWN_DRAWS_HPP
@@ -0,0 +1,164 @@
+/*
+ * A minimal lazy generator based on C++20 coroutines.
+ *
+ * The coroutine runs until it yields a value and is suspended until the next value is
+ * requested. Destroying the generator destroys the coroutine frame, so callers can stop
+ * at any point without paying for the rest.
+ */
+
+#ifndef COUNTDOWN_GENERATOR_HPP
+#define COUNTDOWN_GENERATOR_HPP
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace countdown {
+
+template <typename T>
+class Generator
+{
+public:
+    struct promise_type
+    {
+        std::optional<T> value;
+        std::exception_ptr exception;
+
+        Generator get_return_object() noexcept
+        {
+            return Generator{Handle::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_always final_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_always yield_value(T v) noexcept(std::is_nothrow_move_constructible_v<T>)
+        {
+            value = std::move(v);
+            return {};
+        }
+
+        void return_void() noexcept
+        { }
+
+        void unhandled_exception() noexcept
+        {
+            exception = std::current_exception();
+        }
+    };
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+private:
+    Handle handle_;
+
+    explicit Generator(Handle handle) noexcept
+        : handle_{handle}
+    { }
+
+    void rethrow() const
+    {
+        if (handle_.promise().exception) {
+            std::rethrow_exception(handle_.promise().exception);
+        }
+    }
+
+public:
+    Generator(Generator &&other) noexcept
+        : handle_{std::exchange(other.handle_, nullptr)}
+    { }
+
+    Generator &operator=(Generator &&other) noexcept
+    {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    Generator(Generator const &) = delete;
+    Generator &operator=(Generator const &) = delete;
+
+    ~Generator()
+    {
+        if (handle_) handle_.destroy();
+    }
+
+    // Run until the next value, return it or nothing if the coroutine has finished.
+    std::optional<T> next()
+    {
+        if (not handle_ or handle_.done()) return std::nullopt;
+        handle_.promise().value.reset();
+        handle_.resume();
+        rethrow();
+        if (handle_.done()) return std::nullopt;
+        return std::move(handle_.promise().value);
+    }
+
+    // input iterator for range-for loops
+    class iterator
+    {
+        Generator *gen_{nullptr};
+        std::optional<T> current_;
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        iterator() = default;
+
+        explicit iterator(Generator &gen)
+            : gen_{&gen}, current_{gen.next()}
+        { }
+
+        T &operator*() noexcept
+        {
+            return *current_;
+        }
+
+        iterator &operator++()
+        {
+            current_ = gen_->next();
+            return *this;
+        }
+
+        void operator++(int)
+        {
+            ++*this;
+        }
+
+        friend bool operator==(iterator const &it, std::default_sentinel_t) noexcept
+        {
+            return not it.current_.has_value();
+        }
+    };
+
+    iterator begin()
+    {
+        return iterator{*this};
+    }
+
+    std::default_sentinel_t end() const noexcept
+    {
+        return {};
+    }
+};
+
+}  // namespace countdown
+
+#endif  // COUNTDOWN_GENERATOR_HPP
@@ -11,219 +11,506 @@
  *
  * This implementation uses raw pointers with memory managed from the outside of the
  * solve function. It moves references around without counting them.
+ *
+ * Run with -j N to search on N threads (0 for all hardware threads).
+ * Run with -n N to only print the first N solutions as they are found.
+ * Run with --simplest K to print the K simplest solutions, see best-first.hpp.
+ * Run with --extended to also allow powers (^) and concatenating two numbers of the
+ * draw (|). This searches on one thread.
+ * Run with --use K to only print the solutions that use exactly K numbers, or with
+ * --use-all for the ones that use all of them.
+ * Run with --shallowest to only print the solutions with the fewest operations, found
+ * by iterative deepening.
+ * Run with --deadline-ms N to stop the search after N milliseconds and print what was
+ * found until then, or the closest expression if that was no solution.
+ * Run with --memory-kib N to keep the solutions in N KiB, if they do not fit only a
+ * sample of them is printed and counted in a DP instead, see capped-solve.hpp.
+ * Run with --top K to print the K shortest solutions while keeping only K of them in
+ * memory, --score depth or --score numbers ranks them by depth or numbers used instead.
+ * Run with --stream to print all solutions as soon as they are found instead of after
+ * the search, --dedup drops duplicates on the way and --flush-ms N sets how often the
+ * output is flushed (default 100ms, 0 for every solution).
+ * Run with --format ndjson or --format binary to write only the distinct solutions in a
+ * machine readable format, see solution-format.hpp. This searches on one thread.
+ * Run with --stats to print counters of the search next to the timings.
+ * Run with --trace file.json to write a timeline of the search, the clean up, and the
+ * output on every thread in Chrome trace format.
+ * The options that pick what to print cannot be combined, and an option that the picked
+ * one would ignore (like -j with a single-threaded one) is an error.
+ * Build with -DCOUNTDOWN_TRACK_ALLOCATIONS=ON to also print the allocations of the
+ * search, the clean up, and printing the solutions.
  */
 
 #include <iostream>
+#include <fstream>
 #include <vector>
-#include <memory>
 #include <array>
 #include <string>
 #include <algorithm>
 #include <chrono>
-#include <cassert>
-
-struct Node
+#include <thread>
+#include <atomic>
+#include <optional>
+#include <set>
+#include <unordered_set>
+
+#include "alloc-tracker.hpp"
+#include "best-first.hpp"
+#include "capped-solve.hpp"
+#include "raw-engine.hpp"
+#include "solution-format.hpp"
+#include "top-k.hpp"
+#include "trace.hpp"
+#include "writer.hpp"
+
+using namespace countdown;
+using namespace countdown::raw;
+
+// Print solutions as soon as they are found, drop duplicates if dedup is set.
+// The search runs in the background, also with a single thread, and this thread reads
+// from the collector while the search is going on, so it can flush the output when
+// nothing new comes in.
+void stream(std::vector<Node*> const &workingArray, int const target, unsigned const threads,
+            bool const dedup, std::chrono::milliseconds const flushInterval)
 {
-    enum Kind { val, sum, sub, mul, div };
-
-    Kind kind;
-
-private:
-    int value_{invalid_};
-    Node *a_{nullptr}, *b_{nullptr};
-
-    // cannot have negative number, use -1 as sentinel
-    constexpr static int invalid_ = -1;
-
-public:
-    explicit Node(int const number) noexcept
-        : kind{Kind::val}, value_{number}
-    { }
-
-    explicit Node(Kind const operation,
-                  Node *a, Node *b) noexcept
-        : kind{operation}, a_{a}, b_{b}
-    { }
+    auto startTimeSol = std::chrono::steady_clock::now();
+    std::optional<std::chrono::steady_clock::time_point> firstTimeSol;
+    std::size_t n = 0;
+    // the duplicate filter of the collector filled up, later duplicates got through
+    bool dedupFull = false;
 
-    int eval() noexcept
+    std::cout << "Solutions:\n" << std::flush;
     {
-        if (value_ == invalid_) {
-            switch (kind) {
-            case sum:
-                value_ = a_->eval() + b_->eval();
-                break;
-            case sub:
-                value_ = a_->eval() - b_->eval();
-                break;
-            case mul:
-                value_ = a_->eval() * b_->eval();
-                break;
-            case div:
-                value_ = a_->eval() / b_->eval();
-                break;
-            default:
-                assert(false);
+        BufferedWriter out{std::cout, flushInterval};
+        auto const emit = [&](std::string const &solution) {
+            if (n++ == 0) firstTimeSol = std::chrono::steady_clock::now();
+            out.write(solution);
+            out.write("\n");
+        };
+
+        Collector<std::string> collector(dedup ? dedupCapacity(workingArray, target) : 0);
+        std::atomic<bool> done{false};
+        std::thread search([&] {
+            solveParallel(workingArray, target, threads, collector);
+            done = true;
+        });
+
+        auto reader = collector.reader();
+        while (not done) {
+            if (reader.poll(emit) == 0) {
+                // nothing new, but what is buffered may be due by now
+                out.flushIfDue();
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
             }
         }
-
-        return value_;
-    }
-
-    Node *a() noexcept
-    {
-        return a_;
+        search.join();
+        reader.poll(emit);
+        dedupFull = collector.dedupFull();
     }
+    auto endTimeSol = std::chrono::steady_clock::now();
 
-    Node *b() noexcept
-    {
-        return b_;
+    std::cout << "There are " << n << (dedup ? " 'distinct'" : "") << " solutions\n";
+    if (dedupFull) {
+        std::cout << "The duplicate filter was full, some of them are duplicates\n";
     }
-};
-
-std::string to_string(Node &node)
-{
-    switch (node.kind) {
-    case Node::Kind::val:
-        return std::to_string(node.eval());
-    case Node::Kind::sum:
-        return '('+to_string(*node.a())+" + "+to_string(*node.b())+')';
-    case Node::Kind::sub:
-        return '('+to_string(*node.a())+" - "+to_string(*node.b())+')';
-    case Node::Kind::mul:
-        return '('+to_string(*node.a())+" * "+to_string(*node.b())+')';
-    case Node::Kind::div:
-        return '('+to_string(*node.a())+" / "+to_string(*node.b())+')';
-    }
-    return {};
-}
-
-std::array ops{Node::Kind::sum, Node::Kind::sub, Node::Kind::mul, Node::Kind::div};
-
-
-// turn array into vector of number nodes
-template <size_t N>
-auto toNodes(std::array<int, N> const &numbers)
-{
-    std::vector<std::unique_ptr<Node>> numberNodes;
-    for (int n : numbers) {
-        numberNodes.emplace_back(std::make_unique<Node>(n));
+    std::cout << '\n';
+    if (firstTimeSol) {
+        std::cout << "Time to first solution: "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(*firstTimeSol-startTimeSol).count()
+                  << "ms\n";
     }
-    return numberNodes;
+    std::cout << "Time to solution: "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(endTimeSol-startTimeSol).count()
+              << "ms\n";
 }
 
-// print a collection of nodes
-template <typename NS>
-void printNodes(NS const &ns)
+// Write the distinct solutions as records and nothing else.
+// Duplicates are detected on the packed records, so only new solutions allocate.
+void writeRecords(std::vector<Node*> const &workingArray, int const target, Format const format,
+                  std::chrono::milliseconds const flushInterval)
 {
-    for (auto &node : ns)
-        std::cout << to_string(*node) << '[' << node->eval() << ']' << "  ";
-    std::cout << '\n';
+    std::unordered_set<SolutionRecord, SolutionRecordHash> seen;
+    BufferedWriter out{std::cout, flushInterval};
+    SolutionWriter writer{out, format};
+    forEachSolution(workingArray, target, [&](Node &node) {
+        auto const record = toRecord(node);
+        if (seen.insert(record).second) writer.write(record);
+    });
 }
 
-// copy a vector but leave out one element
-template <typename IT>
-void copyExcept(std::vector<Node*> const &in,
-                IT const &pos,
-                std::vector<Node*> &out)
+int main(int argc, char *argv[])
 {
-    out.clear();
-    for (auto ita = std::cbegin(in); ita != std::cend(in); ++ita) {
-        if (ita != pos) {
-            out.emplace_back(*ita);
+    // number of threads, -j N on the command line
+    unsigned threads = 1;
+    // only show the first solutions, -n N on the command line, 0 for all
+    std::size_t first = 0;
+    // only show the simplest solutions, --simplest K on the command line, 0 for all
+    std::size_t simplest = 0;
+    // also allow ^ and concatenation, --extended
+    bool extended = false;
+    // only show solutions with this many numbers, --use K or --use-all, 0 for any
+    std::size_t use = 0;
+    bool useAll = false;
+    // only show the solutions with the fewest operations, --shallowest
+    bool shallowest = false;
+    // stop searching after this long, --deadline-ms N
+    std::optional<std::chrono::milliseconds> deadline;
+    // most memory for the solutions, --memory-kib N
+    std::optional<std::size_t> memoryBudget;
+    // only show the best solutions by a score, --top K [--score length|depth|numbers]
+    std::size_t top = 0;
+    Score score = length;
+    // print solutions while searching, --stream [--dedup] [--flush-ms N]
+    bool streaming = false;
+    bool dedup = false;
+    std::chrono::milliseconds flushInterval{100};
+    // text for people, --format ndjson|binary for programs
+    Format format = Format::text;
+    // count what the search does, --stats
+    bool withStats = false;
+    // write a timeline of the run, --trace path
+    std::string tracePath;
+    // the options on the command line, to reject the ones the mode would ignore
+    std::set<std::string> given;
+    for (int i = 1; i < argc; ++i) {
+        std::string const arg = argv[i];
+        given.insert(arg);
+        if (arg == "-j" and i+1 < argc) {
+            threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        }
+        else if (arg == "-n" and i+1 < argc) {
+            first = std::stoul(argv[++i]);
+        }
+        else if (arg == "--simplest" and i+1 < argc) {
+            simplest = std::stoul(argv[++i]);
+        }
+        else if (arg == "--extended") {
+            extended = true;
+        }
+        else if (arg == "--use" and i+1 < argc) {
+            use = std::stoul(argv[++i]);
+        }
+        else if (arg == "--use-all") {
+            useAll = true;
+        }
+        else if (arg == "--shallowest") {
+            shallowest = true;
+        }
+        else if (arg == "--deadline-ms" and i+1 < argc) {
+            deadline = std::chrono::milliseconds{std::stol(argv[++i])};
+        }
+        else if (arg == "--memory-kib" and i+1 < argc) {
+            memoryBudget = std::stoul(argv[++i]) << 10;
+        }
+        else if (arg == "--top" and i+1 < argc) {
+            top = std::stoul(argv[++i]);
+        }
+        else if (arg == "--score" and i+1 < argc) {
+            std::string const name = argv[++i];
+            if (name == "length") score = length;
+            else if (name == "depth") score = depth;
+            else if (name == "numbers") score = numbersUsed;
+            else {
+                std::cerr << "unknown score " << name << '\n';
+                return 1;
+            }
+        }
+        else if (arg == "--stream") {
+            streaming = true;
+        }
+        else if (arg == "--dedup") {
+            dedup = true;
+        }
+        else if (arg == "--flush-ms" and i+1 < argc) {
+            flushInterval = std::chrono::milliseconds{std::stol(argv[++i])};
+        }
+        else if (arg == "--stats") {
+            withStats = true;
+        }
+        else if (arg == "--trace" and i+1 < argc) {
+            tracePath = argv[++i];
+        }
+        else if (arg == "--format" and i+1 < argc) {
+            std::string const name = argv[++i];
+            if (name == "ndjson") format = Format::ndjson;
+            else if (name == "binary") format = Format::binary;
+            else if (name != "text") {
+                std::cerr << "unknown format " << name << '\n';
+                return 1;
+            }
+        }
+        else {
+            std::cerr << "unknown option " << arg << '\n';
+            return 1;
         }
     }
-}
-
 
-// Solve the game recursively.
-// Use a set of starting nodes and try all binary combinations.
-// Recurse with a vector with two nodes erased and one extra node for the new operation.
-// The node memory must be maintained by the caller.
-std::vector<std::string> solve(std::vector<Node*> const &startNodes,
-                               int const target)
-{
-    std::vector<std::string> solutions;
-    std::vector<Node*> auxNodes, newNodes;
-    auxNodes.reserve(std::size(startNodes)-1);
-    newNodes.reserve(std::size(startNodes)-2);
-
-    for (auto ita = std::cbegin(startNodes); ita != std::cend(startNodes); ++ita) {
-        // first operand to try
-        Node * const nodea = *ita;
-        // new vector without nodea
-        copyExcept(startNodes, ita, auxNodes);
-
-        for (auto itb = std::cbegin(auxNodes); itb != std::cend(auxNodes); ++itb) {
-            // second operand to try
-            Node * const nodeb = *itb;
-
-            // only try every pair once: the order that is ok for sub
-            if (nodea->eval() <= nodeb->eval()) continue;
-
-            // new vector without nodeb and nodea
-            copyExcept(auxNodes, itb, newNodes);
-
-            for (auto op : ops) {
-                // skip divisions with remainder
-                if (op == Node::Kind::div and nodea->eval() % nodeb->eval() != 0) continue;
-
-                // make a new binary node
-                Node opNode(op, nodea, nodeb);
-                if (opNode.eval() == target) {
-                    solutions.emplace_back(to_string(opNode));
-                    // don't 'continue' because we might be able to add zero or multiply by one
-                }
-                newNodes.emplace_back(&opNode);
-
-                // recurse if enough nodes left
-                if (std::size(newNodes) > 1) {
-                    auto const sols = solve(newNodes, target);
-                    std::copy(std::begin(sols), std::end(sols), std::back_inserter(solutions));
-                }
-
-                newNodes.pop_back();
-            }
+    // Each of these picks what to print, at most one of them goes. The rest of the
+    // options only apply to some of them, "" is printing all solutions.
+    if (threads == 1) given.erase("-j");
+    std::vector<std::string> modes;
+    for (auto const mode : {"--format", "-n", "--simplest", "--use", "--use-all", "--shallowest",
+                            "--deadline-ms", "--memory-kib", "--top", "--stream", "--extended"}) {
+        if (given.count(mode)) modes.push_back(mode);
+    }
+    if (format == Format::text) std::erase(modes, "--format");
+    if (std::size(modes) > 1) {
+        std::cerr << modes[0] << " and " << modes[1] << " cannot be combined\n";
+        return 1;
+    }
+    std::string const mode = std::empty(modes) ? "" : modes[0];
+    struct Restriction
+    {
+        std::string option;
+        std::set<std::string> modes;
+    };
+    for (auto const &[option, allowed] : {
+             // the other modes search on one thread
+             Restriction{"-j", {"", "--stream"}},
+             Restriction{"--stats", {""}},
+             // the other modes record nothing
+             Restriction{"--trace", {"", "--extended", "--memory-kib", "--stream"}},
+             Restriction{"--score", {"--top"}},
+             Restriction{"--dedup", {"--stream"}},
+             Restriction{"--flush-ms", {"--stream", "--format"}}}) {
+        if (not given.count(option) or allowed.count(mode)) continue;
+        if (mode.empty()) {
+            std::cerr << option << " needs one of";
+            for (auto const &m : allowed) std::cerr << ' ' << m;
+            std::cerr << '\n';
+        }
+        else {
+            std::cerr << option << " does not apply to " << mode << '\n';
         }
+        return 1;
     }
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
 
-    return solutions;
-}
+    // written when main returns, whichever way the solutions are produced
+    struct TraceFile
+    {
+        std::string path;
+        ~TraceFile()
+        {
+            if (path.empty()) return;
+            std::ofstream file(path);
+            trace::write(file);
+        }
+    } const traceFile{tracePath};
+    if (not tracePath.empty()) trace::start();
 
-int main()
-{
     // the number we want to get
     constexpr int target = 784;
     // the input numbers
     constexpr std::array numbers{100, 50, 9, 5, 2, 4};
 
+    if (format != Format::text) {
+        auto numberNodes = toNodes(numbers);
+        writeRecords(toPointers(numberNodes), target, format, flushInterval);
+        return 0;
+    }
+
     // turn them into nodes
     std::cout << "Numbers:\n";
     auto numberNodes = toNodes(numbers);
     printNodes(numberNodes);
     std::cout << '\n';
 
-    std::vector<Node*> workingArray;
-    std::transform(std::begin(numberNodes), std::end(numberNodes),
-                   std::back_inserter(workingArray),
-                   [](std::unique_ptr<Node> const &ptr) { return ptr.get(); });
+    auto workingArray = toPointers(numberNodes);
+
+    if (first != 0) {
+        // search only as far as needed, solutions are not sorted or deduplicated
+        auto startTimeFirst = std::chrono::steady_clock::now();
+        std::cout << "First solutions:\n";
+        std::size_t n = 0;
+        for (auto const &solution : lazySolve(workingArray, target)) {
+            std::cout << solution << '\n';
+            if (++n == first) break;
+        }
+        auto endTimeFirst = std::chrono::steady_clock::now();
+
+        std::cout << '\n';
+        std::cout << "Time to " << n << " solutions: "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(endTimeFirst-startTimeFirst).count()
+                  << "ms\n";
+        return 0;
+    }
+
+    if (simplest != 0) {
+        // best-first, stops as soon as the simplest ones are known
+        auto startTimeSimplest = std::chrono::steady_clock::now();
+        auto const ranked = simplestSolutions({std::begin(numbers), std::end(numbers)}, target,
+                                              simplest);
+        auto endTimeSimplest = std::chrono::steady_clock::now();
+
+        std::cout << "Simplest solutions:\n";
+        for (auto const &solution : ranked) {
+            std::cout << solution.expression << "  [cost " << solution.cost << "]\n";
+        }
+        std::cout << '\n';
+        std::cout << "Time to " << std::size(ranked) << " simplest solutions: "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(endTimeSimplest-startTimeSimplest).count()
+                  << "ms\n";
+        return 0;
+    }
+
+    if (useAll) use = std::size(numbers);
+    if (use != 0) {
+        auto startTimeSol = std::chrono::steady_clock::now();
+        auto solutions = solveUsing(workingArray, target, use);
+        auto endTimeSol = std::chrono::steady_clock::now();
+        std::sort(std::begin(solutions), std::end(solutions));
+        solutions.erase(std::unique(std::begin(solutions), std::end(solutions)),
+                        std::end(solutions));
+
+        std::cout << "Solutions with " << use << " numbers:\n";
+        for (auto const &solution : solutions)
+            std::cout << solution << '\n';
+        std::cout << "There are " << std::size(solutions) << " 'distinct' solutions\n";
+
+        std::cout << '\n';
+        std::cout << "Time to solution: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(endTimeSol-startTimeSol).count()
+                  << "us\n";
+        return 0;
+    }
+
+    if (shallowest) {
+        auto startTimeSol = std::chrono::steady_clock::now();
+        auto const result = solveShallowest(workingArray, target);
+        auto endTimeSol = std::chrono::steady_clock::now();
+
+        std::cout << "Solutions with " << result.operations << " operations:\n";
+        for (auto const &solution : result.solutions)
+            std::cout << solution << '\n';
+        std::cout << "There are " << std::size(result.solutions) << " 'distinct' solutions\n";
+
+        std::cout << '\n';
+        std::cout << "Time to solution: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(endTimeSol-startTimeSol).count()
+                  << "us\n";
+        return 0;
+    }
+
+    if (deadline) {
+        auto startTimeSol = std::chrono::steady_clock::now();
+        auto const result = solveUntil(workingArray, target, startTimeSol + *deadline);
+        auto endTimeSol = std::chrono::steady_clock::now();
+
+        if (std::empty(result.solutions)) {
+            std::cout << "No solution, closest:\n"
+                      << result.closest << " [" << result.closestValue << "]\n";
+        }
+        else {
+            std::cout << "Solutions:\n";
+            for (auto const &solution : result.solutions)
+                std::cout << solution << '\n';
+            std::cout << "There are " << std::size(result.solutions) << " 'distinct' solutions\n";
+        }
+        std::cout << (result.complete ? "The search is complete\n"
+                                      : "The search ran out of time\n");
+
+        std::cout << '\n';
+        std::cout << "Time to solution: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(endTimeSol-startTimeSol).count()
+                  << "us\n";
+        return 0;
+    }
+
+    if (memoryBudget) {
+        auto startTimeSol = std::chrono::steady_clock::now();
+        auto const result = solveCapped({std::begin(numbers), std::end(numbers)}, target,
+                                        *memoryBudget);
+        auto endTimeSol = std::chrono::steady_clock::now();
+
+        std::cout << (result.sampled ? "Sample of the solutions:\n" : "Solutions:\n");
+        for (auto const &solution : result.solutions)
+            std::cout << solution << '\n';
+        std::cout << "There are " << result.count << " 'distinct' solutions\n";
+        if (result.deduplicatedEarly) {
+            std::cout << "Duplicates were dropped during the search to save memory\n";
+        }
+        if (result.sampled) {
+            std::cout << "Only " << std::size(result.solutions)
+                      << " of them were kept, the count comes from a DP\n";
+        }
+        if (result.truncated) {
+            std::cout << "The sample only covers the solutions found before the memory ran out\n";
+        }
+
+        std::cout << '\n';
+        std::cout << "Time to solution: "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(endTimeSol-startTimeSol).count()
+                  << "ms\n";
+        return 0;
+    }
+
+    if (top != 0) {
+        auto startTimeTop = std::chrono::steady_clock::now();
+        auto const best = topK(workingArray, target, top, score);
+        auto endTimeTop = std::chrono::steady_clock::now();
+
+        std::cout << "Best solutions:\n";
+        for (auto const &solution : best) {
+            std::cout << solution.expression << "  [score " << solution.score << "]\n";
+        }
+        std::cout << '\n';
+        std::cout << "Time to " << std::size(best) << " best solutions: "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(endTimeTop-startTimeTop).count()
+                  << "ms\n";
+        return 0;
+    }
+
+    if (streaming) {
+        stream(workingArray, target, threads, dedup, flushInterval);
+        return 0;
+    }
 
     // solve
+    SearchStats stats;
+    AllocStats allocsSol, allocsUnique, allocsPrint;
+    if constexpr (trackAllocations) resetAllocStats();
+    trace::Scope search("search");
     auto startTimeSol = std::chrono::steady_clock::now();
-    auto solutions = solve(workingArray, target);
+    std::vector<std::string> solutions;
+    if (extended) {
+        solutions = solveWith<Extended>(workingArray, target);
+    }
+    else if (withStats) {
+        solutions = threads == 1
+            ? solve(workingArray, target, stats)
+            : solveParallel(workingArray, target, threads, stats);
+    }
+    else {
+        solutions = threads == 1
+            ? solve(workingArray, target)
+            : solveParallel(workingArray, target, threads);
+    }
     auto endTimeSol = std::chrono::steady_clock::now();
+    search.close();
+    if constexpr (trackAllocations) allocsSol = allocStats();
     std::cout << '\n';
 
     // erase all duplicates
+    if constexpr (trackAllocations) resetAllocStats();
+    trace::Scope cleanUp("dedup");
     auto startTimeUnique = std::chrono::steady_clock::now();
     std::sort(std::begin(solutions), std::end(solutions));
     solutions.erase(std::unique(std::begin(solutions), std::end(solutions)),
                     std::end(solutions));
     auto endTimeUnique = std::chrono::steady_clock::now();
+    cleanUp.close();
+    if constexpr (trackAllocations) allocsUnique = allocStats();
+    stats.duplicates = stats.hits - std::size(solutions);
 
+    if constexpr (trackAllocations) resetAllocStats();
+    trace::Scope output("output");
     std::cout << "Solutions:\n";
     for (auto &solution : solutions)
         std::cout << solution << '\n';
     std::cout << "There are " << std::size(solutions) << " 'distinct' solutions\n";
+    output.close();
+    if constexpr (trackAllocations) allocsPrint = allocStats();
 
 
     std::cout << '\n';
@@ -233,4 +520,17 @@ int main()
     std::cout << "Time to clean up: "
               << std::chrono::duration_cast<std::chrono::milliseconds>(endTimeUnique-startTimeUnique).count()
               << "ms\n";
+    if constexpr (trackAllocations) {
+        std::cout << "Allocations to solution: ";
+        print(std::cout, allocsSol);
+        std::cout << "\nAllocations to clean up: ";
+        print(std::cout, allocsUnique);
+        std::cout << "\nAllocations to print: ";
+        print(std::cout, allocsPrint);
+        std::cout << '\n';
+    }
+    if (withStats) {
+        std::cout << '\n';
+        print(std::cout, stats);
+    }
 }
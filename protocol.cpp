@@ -0,0 +1,251 @@
+#include "protocol.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace countdown::protocol {
+
+namespace {
+    class Writer
+    {
+        std::vector<std::uint8_t> &out_;
+
+    public:
+        explicit Writer(std::vector<std::uint8_t> &out) noexcept
+            : out_{out}
+        { }
+
+        template <typename T>
+        void put(T const value)
+        {
+            auto const v = static_cast<std::uint64_t>(value);
+            for (std::size_t byte = 0; byte < sizeof(T); ++byte) {
+                out_.push_back(static_cast<std::uint8_t>(v >> (8*byte)));
+            }
+        }
+
+        void put(std::string const &s)
+        {
+            put(static_cast<std::uint32_t>(std::size(s)));
+            out_.insert(std::end(out_), std::begin(s), std::end(s));
+        }
+    };
+
+    class Reader
+    {
+        std::vector<std::uint8_t> const &in_;
+        std::size_t pos_{0};
+
+        void need(std::size_t const n) const
+        {
+            if (std::size(in_) - pos_ < n) {
+                throw std::runtime_error("truncated message");
+            }
+        }
+
+    public:
+        explicit Reader(std::vector<std::uint8_t> const &in) noexcept
+            : in_{in}
+        { }
+
+        template <typename T>
+        T get()
+        {
+            need(sizeof(T));
+            std::uint64_t v = 0;
+            for (std::size_t byte = 0; byte < sizeof(T); ++byte) {
+                v |= static_cast<std::uint64_t>(in_[pos_++]) << (8*byte);
+            }
+            return static_cast<T>(v);
+        }
+
+        std::string getString()
+        {
+            auto const n = get<std::uint32_t>();
+            need(n);
+            std::string s(reinterpret_cast<char const*>(in_.data() + pos_), n);
+            pos_ += n;
+            return s;
+        }
+
+        // a count of elements that take at least size bytes each, checked against what is left
+        std::uint32_t getCount(std::size_t const size)
+        {
+            auto const n = get<std::uint32_t>();
+            need(static_cast<std::size_t>(n) * size);
+            return n;
+        }
+    };
+
+    Op checkedOp(std::uint8_t const op)
+    {
+        if (op < static_cast<std::uint8_t>(Op::solve) or op > static_cast<std::uint8_t>(Op::reachable)) {
+            throw std::runtime_error("unknown operation");
+        }
+        return static_cast<Op>(op);
+    }
+
+    // read or write exactly n bytes, return the number done before the peer closed
+    template <typename F>
+    std::size_t transfer(F &&f, std::size_t const n)
+    {
+        std::size_t done = 0;
+        while (done < n) {
+            auto const r = f(done);
+            if (r == 0) break;
+            if (r < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+            }
+            done += static_cast<std::size_t>(r);
+        }
+        return done;
+    }
+}
+
+std::vector<std::uint8_t> encode(Request const &request)
+{
+    std::vector<std::uint8_t> out;
+    Writer w{out};
+    w.put(static_cast<std::uint8_t>(request.op));
+    w.put(static_cast<std::uint8_t>(request.engine));
+    w.put(static_cast<std::uint16_t>(request.threads));
+    w.put(static_cast<std::int32_t>(request.target));
+    w.put(static_cast<std::uint8_t>(std::size(request.numbers)));
+    for (int const n : request.numbers) {
+        w.put(static_cast<std::int32_t>(n));
+    }
+    return out;
+}
+
+std::vector<std::uint8_t> encode(Response const &response)
+{
+    std::vector<std::uint8_t> out;
+    Writer w{out};
+    w.put(static_cast<std::uint8_t>(response.op));
+    w.put(static_cast<std::uint8_t>(response.error.empty() ? 0 : 1));
+    if (not response.error.empty()) {
+        w.put(response.error);
+        return out;
+    }
+
+    switch (response.op) {
+    case Op::solve:
+        w.put(static_cast<std::uint32_t>(std::size(response.solutions)));
+        for (auto const &s : response.solutions) {
+            w.put(s);
+        }
+        w.put(response.count);
+        break;
+    case Op::count:
+        w.put(response.count);
+        break;
+    case Op::nearest:
+        w.put(static_cast<std::int32_t>(response.value));
+        break;
+    case Op::reachable:
+        w.put(static_cast<std::uint32_t>(std::size(response.values)));
+        for (int const v : response.values) {
+            w.put(static_cast<std::int32_t>(v));
+        }
+        break;
+    }
+    return out;
+}
+
+Request decodeRequest(std::vector<std::uint8_t> const &payload)
+{
+    Reader r{payload};
+    Request request;
+    request.op = checkedOp(r.get<std::uint8_t>());
+    auto const engine = r.get<std::uint8_t>();
+    if (engine > static_cast<std::uint8_t>(Engine::bitset)) {
+        throw std::runtime_error("unknown engine");
+    }
+    request.engine = static_cast<Engine>(engine);
+    request.threads = r.get<std::uint16_t>();
+    request.target = r.get<std::int32_t>();
+    auto const n = r.get<std::uint8_t>();
+    for (unsigned i = 0; i < n; ++i) {
+        request.numbers.push_back(r.get<std::int32_t>());
+    }
+    return request;
+}
+
+Response decodeResponse(std::vector<std::uint8_t> const &payload)
+{
+    Reader r{payload};
+    Response response;
+    response.op = checkedOp(r.get<std::uint8_t>());
+    if (r.get<std::uint8_t>() != 0) {
+        response.error = r.getString();
+        return response;
+    }
+
+    switch (response.op) {
+    case Op::solve:
+        for (auto n = r.getCount(4); n > 0; --n) {
+            response.solutions.push_back(r.getString());
+        }
+        response.count = r.get<std::uint64_t>();
+        break;
+    case Op::count:
+        response.count = r.get<std::uint64_t>();
+        break;
+    case Op::nearest:
+        response.value = r.get<std::int32_t>();
+        break;
+    case Op::reachable:
+        for (auto n = r.getCount(4); n > 0; --n) {
+            response.values.push_back(r.get<std::int32_t>());
+        }
+        break;
+    }
+    return response;
+}
+
+bool readFrame(int const fd, std::vector<std::uint8_t> &payload)
+{
+    std::uint8_t header[4];
+    auto const got = transfer([&](std::size_t const done) {
+        return ::read(fd, header + done, sizeof(header) - done);
+    }, sizeof(header));
+    if (got == 0) return false;
+    if (got != sizeof(header)) throw std::runtime_error("truncated frame");
+
+    std::uint32_t const size = header[0] | header[1] << 8 | header[2] << 16
+        | static_cast<std::uint32_t>(header[3]) << 24;
+    if (size > maxFrameSize) throw std::runtime_error("frame too large");
+
+    payload.resize(size);
+    if (transfer([&](std::size_t const done) {
+            return ::read(fd, payload.data() + done, size - done);
+        }, size) != size) {
+        throw std::runtime_error("truncated frame");
+    }
+    return true;
+}
+
+void writeFrame(int const fd, std::vector<std::uint8_t> const &payload)
+{
+    if (std::size(payload) > maxFrameSize) throw std::runtime_error("frame too large");
+
+    auto const size = static_cast<std::uint32_t>(std::size(payload));
+    std::vector<std::uint8_t> frame{
+        static_cast<std::uint8_t>(size), static_cast<std::uint8_t>(size >> 8),
+        static_cast<std::uint8_t>(size >> 16), static_cast<std::uint8_t>(size >> 24)};
+    frame.insert(std::end(frame), std::begin(payload), std::end(payload));
+
+    // MSG_NOSIGNAL: a client that went away must not kill the server with SIGPIPE
+    if (transfer([&](std::size_t const done) {
+            return ::send(fd, frame.data() + done, std::size(frame) - done, MSG_NOSIGNAL);
+        }, std::size(frame)) != std::size(frame)) {
+        throw std::runtime_error("connection closed");
+    }
+}
+
+}  // namespace countdown::protocol
@@ -0,0 +1,77 @@
+/*
+ * Binary protocol between countdown-server and its clients.
+ *
+ * Every message is a frame: a 4 byte little endian length followed by that many bytes
+ * of payload. All integers in the payload are little endian as well.
+ *
+ * Request:  op (u8), engine (u8), threads (u16), target (i32), n (u8), numbers (n x i32)
+ * Response: op (u8), status (u8), then for status ok
+ *             solve:     count (u32), count x (length (u32), bytes), total (u64)
+ *             count:     count (u64)
+ *             nearest:   value (i32)
+ *             reachable: count (u32), count x value (i32)
+ *           and for status error: length (u32), message bytes
+ */
+
+#ifndef COUNTDOWN_PROTOCOL_HPP
+#define COUNTDOWN_PROTOCOL_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "countdown.hpp"
+
+namespace countdown::protocol {
+
+enum class Op : std::uint8_t
+{
+    solve = 1,
+    count = 2,
+    nearest = 3,
+    reachable = 4,
+};
+
+struct Request
+{
+    Op op = Op::count;
+    Engine engine = Engine::automatic;
+    unsigned threads = 1;
+    int target = 0;
+    std::vector<int> numbers;
+};
+
+struct Response
+{
+    Op op = Op::count;
+    // empty on success
+    std::string error;
+    // the result, which one is set depends on op
+    std::vector<std::string> solutions;
+    // for solve, the number of distinct solutions, more than solutions if that is
+    // only a sample of them
+    std::uint64_t count = 0;
+    int value = 0;
+    std::vector<int> values;
+};
+
+// largest frame either side accepts, protects against garbage lengths
+constexpr std::uint32_t maxFrameSize = 64u << 20;
+
+std::vector<std::uint8_t> encode(Request const &request);
+std::vector<std::uint8_t> encode(Response const &response);
+
+// throw std::runtime_error if the payload is malformed
+Request decodeRequest(std::vector<std::uint8_t> const &payload);
+Response decodeResponse(std::vector<std::uint8_t> const &payload);
+
+// Read one frame from a socket, return false if the peer closed the connection
+// before the frame started. Throws std::runtime_error on errors and truncated frames.
+bool readFrame(int fd, std::vector<std::uint8_t> &payload);
+
+// Write one frame to a socket, throws std::runtime_error on errors.
+void writeFrame(int fd, std::vector<std::uint8_t> const &payload);
+
+}  // namespace countdown::protocol
+
+#endif  // COUNTDOWN_PROTOCOL_HPP
@@ -0,0 +1,551 @@
+#include "raw-engine.hpp"
+#include "collector.hpp"
+#include "solution-count.hpp"
+#include "trace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+#include <optional>
+#include <thread>
+#include <utility>
+
+namespace countdown::raw {
+
+std::string to_string(Node &node)
+{
+    switch (node.kind) {
+    case Node::Kind::val:
+        return std::to_string(node.eval());
+    case Node::Kind::sum:
+        return '('+to_string(*node.a())+" + "+to_string(*node.b())+')';
+    case Node::Kind::sub:
+        return '('+to_string(*node.a())+" - "+to_string(*node.b())+')';
+    case Node::Kind::mul:
+        return '('+to_string(*node.a())+" * "+to_string(*node.b())+')';
+    case Node::Kind::div:
+        return '('+to_string(*node.a())+" / "+to_string(*node.b())+')';
+    case Node::Kind::pow:
+        return '('+to_string(*node.a())+" ^ "+to_string(*node.b())+')';
+    case Node::Kind::cat:
+        return '('+to_string(*node.a())+" | "+to_string(*node.b())+')';
+    }
+    return {};
+}
+
+int numbersUsed(Node &node)
+{
+    if (node.kind == Node::Kind::val) return 1;
+    return numbersUsed(*node.a()) + numbersUsed(*node.b());
+}
+
+std::vector<Node*> toPointers(std::vector<std::unique_ptr<Node>> const &nodes)
+{
+    std::vector<Node*> pointers;
+    std::transform(std::begin(nodes), std::end(nodes),
+                   std::back_inserter(pointers),
+                   [](std::unique_ptr<Node> const &ptr) { return ptr.get(); });
+    return pointers;
+}
+
+namespace {
+    // the operations of lazySolve, the Standard ones
+    std::array ops{Node::Kind::sum, Node::Kind::sub, Node::Kind::mul, Node::Kind::div};
+
+    // copy a vector but leave out one element
+    template <typename IT>
+    void copyExcept(std::vector<Node*> const &in,
+                    IT const &pos,
+                    std::vector<Node*> &out)
+    {
+        out.clear();
+        for (auto ita = std::cbegin(in); ita != std::cend(in); ++ita) {
+            if (ita != pos) {
+                out.emplace_back(*ita);
+            }
+        }
+    }
+
+    // How far the search goes, apart from what it counts in Stats (search-stats.hpp).
+    // The search shows every node it makes to made(), stops as soon as stopped() is
+    // true, and only makes nodes at a depth if descend(depth) is true.
+    // Exhaustive goes through everything, the policies further down cut it short.
+    struct Exhaustive
+    {
+        void made(Node &) noexcept { }
+        bool stopped() const noexcept { return false; }
+        bool descend(std::size_t) const noexcept { return true; }
+    };
+
+    template <typename OpSet = Standard, typename F, typename Stats, typename Policy>
+    void search(std::vector<Node*> const &startNodes, int target, F &found, Stats &stats,
+                Policy &policy, std::size_t depth = 0);
+
+    // Try operator Op on nodea and nodeb and recurse with the new node added to
+    // newNodes. Returns false if the search was stopped.
+    template <typename OpSet, typename Op, typename F, typename Stats, typename Policy>
+    bool tryOperation(Node * const nodea, Node * const nodeb,
+                      std::vector<Node*> &newNodes, int const target, F &found,
+                      Stats &stats, Policy &policy, std::size_t const depth)
+    {
+        if constexpr (OpSet::unordered and Op::ordered) {
+            // the pair comes in the other order as well
+            if (nodea->eval() <= nodeb->eval()) return true;
+        }
+        if (not Op::valid(*nodea, *nodeb)) {
+            if constexpr (Op::kind == Node::div) stats.remainderReject();
+            return true;
+        }
+
+        // make a new binary node
+        Node opNode(Op::kind, nodea, nodeb);
+        stats.node(depth);
+        policy.made(opNode);
+        if (opNode.eval() == target) {
+            stats.hit();
+            found(opNode);
+            // don't stop because we might be able to add zero or multiply by one
+        }
+        newNodes.emplace_back(&opNode);
+
+        // recurse if enough nodes left
+        if (std::size(newNodes) > 1 and policy.descend(depth+1)) {
+            search<OpSet>(newNodes, target, found, stats, policy, depth+1);
+        }
+
+        newNodes.pop_back();
+        return not policy.stopped();
+    }
+
+    template <typename OpSet, typename... Ops, typename F, typename Stats, typename Policy>
+    void tryEach(Operators<Ops...>, Node * const nodea, Node * const nodeb,
+                 std::vector<Node*> &newNodes, int const target, F &found,
+                 Stats &stats, Policy &policy, std::size_t const depth)
+    {
+        (tryOperation<OpSet, Ops>(nodea, nodeb, newNodes, target, found, stats, policy, depth)
+         and ...);
+    }
+
+    // Try all operations on nodea and nodeb, which must satisfy nodea > nodeb unless
+    // OpSet is unordered.
+    // Recurse with the new node added to newNodes which must hold all other remaining nodes.
+    // depth is the number of operations that nodea and nodeb were made with.
+    template <typename OpSet = Standard, typename F, typename Stats, typename Policy>
+    void tryOperations(Node * const nodea, Node * const nodeb,
+                       std::vector<Node*> &newNodes, int const target, F &found,
+                       Stats &stats, Policy &policy, std::size_t const depth = 0)
+    {
+        tryEach<OpSet>(OpSet{}, nodea, nodeb, newNodes, target, found, stats, policy, depth);
+    }
+
+    // Search the game recursively.
+    // Use a set of starting nodes and try all binary combinations.
+    // Recurse with a vector with two nodes erased and one extra node for the new operation.
+    // Calls found(node) for every node that evaluates to target, the node is only valid
+    // during the call.
+    template <typename OpSet, typename F, typename Stats, typename Policy>
+    void search(std::vector<Node*> const &startNodes, int const target, F &found, Stats &stats,
+                Policy &policy, std::size_t const depth)
+    {
+        std::vector<Node*> auxNodes, newNodes;
+        auxNodes.reserve(std::size(startNodes)-1);
+        newNodes.reserve(std::size(startNodes)-1);
+
+        for (auto ita = std::cbegin(startNodes); ita != std::cend(startNodes); ++ita) {
+            // first operand to try
+            Node * const nodea = *ita;
+            // new vector without nodea
+            copyExcept(startNodes, ita, auxNodes);
+
+            for (auto itb = std::cbegin(auxNodes); itb != std::cend(auxNodes); ++itb) {
+                // second operand to try
+                Node * const nodeb = *itb;
+
+                // only try every pair once: the order that is ok for sub
+                if constexpr (not OpSet::unordered) {
+                    if (nodea->eval() <= nodeb->eval()) {
+                        stats.orderReject();
+                        continue;
+                    }
+                }
+
+                // new vector without nodeb and nodea
+                copyExcept(auxNodes, itb, newNodes);
+                tryOperations<OpSet>(nodea, nodeb, newNodes, target, found, stats, policy, depth);
+                if (policy.stopped()) return;
+            }
+        }
+    }
+
+    // Stops the search once the deadline has passed and remembers the node closest to
+    // the target. The clock is only read every few thousand nodes.
+    class Deadline : public Exhaustive
+    {
+        std::chrono::steady_clock::time_point deadline_;
+        int target_;
+        std::uint32_t nodes_{0};
+        bool expired_{false};
+
+    public:
+        constexpr static std::uint32_t checkInterval = 4096;
+
+        std::string closest{};
+        int closestValue{0};
+        long closestDistance{std::numeric_limits<long>::max()};
+
+        Deadline(std::chrono::steady_clock::time_point const deadline, int const target)
+            : deadline_{deadline}, target_{target}
+        { }
+
+        void made(Node &node)
+        {
+            if (++nodes_ % checkInterval == 0
+                and std::chrono::steady_clock::now() >= deadline_) {
+                expired_ = true;
+            }
+
+            long const distance = std::labs(static_cast<long>(node.eval()) - target_);
+            // prefer the smaller value on ties, like nearest()
+            if (distance < closestDistance
+                or (distance == closestDistance and node.eval() < closestValue)) {
+                closest = to_string(node);
+                closestValue = node.eval();
+                closestDistance = distance;
+            }
+        }
+
+        bool stopped() const noexcept
+        {
+            return expired_;
+        }
+    };
+
+    // Only makes nodes with fewer than a number of operations done before them.
+    struct DepthLimit : Exhaustive
+    {
+        std::size_t operations;
+
+        bool descend(std::size_t const depth) const noexcept
+        {
+            return depth < operations;
+        }
+    };
+
+    // one level of the search in lazySolve
+    struct Frame
+    {
+        std::vector<Node*> nodes;
+        // the current operands and operation
+        std::size_t a{0}, b{0}, op{0};
+        // the node made by the current operation, referenced by deeper frames
+        std::optional<Node> opNode{};
+    };
+
+    // The items of a collector with deduplication, without duplicates even if its set
+    // filled up, which only happens if the DP undercounted.
+    std::vector<std::string> distinctItems(Collector<std::string> const &collector)
+    {
+        auto items = collector.items();
+        if (collector.dedupFull()) {
+            std::sort(std::begin(items), std::end(items));
+            items.erase(std::unique(std::begin(items), std::end(items)), std::end(items));
+        }
+        return items;
+    }
+
+    // Search on several threads, every thread counts into its own stats.
+    template <typename Stats>
+    void parallelSearch(std::vector<Node*> const &startNodes, int const target,
+                        unsigned const threads, Collector<std::string> &collector,
+                        std::vector<Stats> &stats)
+    {
+        stats.resize(threads);
+
+        // all pairs in the order that is ok for sub
+        std::vector<std::pair<std::size_t, std::size_t>> pairs;
+        for (std::size_t a = 0; a < std::size(startNodes); ++a) {
+            for (std::size_t b = 0; b < std::size(startNodes); ++b) {
+                if (startNodes[a]->eval() > startNodes[b]->eval()) {
+                    pairs.emplace_back(a, b);
+                }
+                else if (a != b) {
+                    stats[0].orderReject();
+                }
+            }
+        }
+
+        std::atomic<std::size_t> next{0};
+
+        auto const work = [&](Stats &threadStats) {
+            trace::Scope const worker("worker");
+            Exhaustive everything;
+            auto writer = collector.writer();
+            auto found = [&](Node &node) {
+                writer.push(to_string(node));
+            };
+
+            std::vector<Node*> newNodes;
+            newNodes.reserve(std::size(startNodes)-1);
+            for (;;) {
+                std::size_t const i = next.fetch_add(1, std::memory_order_relaxed);
+                if (i >= std::size(pairs)) break;
+                auto const [a, b] = pairs[i];
+                trace::Scope const subtree("subtree");
+
+                // new vector without nodea and nodeb
+                newNodes.clear();
+                for (std::size_t k = 0; k < std::size(startNodes); ++k) {
+                    if (k != a and k != b) newNodes.emplace_back(startNodes[k]);
+                }
+                tryOperations(startNodes[a], startNodes[b], newNodes, target, found, threadStats,
+                              everything);
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threads; ++t) {
+            pool.emplace_back(work, std::ref(stats[t]));
+        }
+        work(stats[0]);
+        for (auto &thread : pool) {
+            thread.join();
+        }
+    }
+}
+
+std::vector<std::string> solve(std::vector<Node*> const &startNodes,
+                               int const target)
+{
+    NoStats stats;
+    Exhaustive everything;
+    std::vector<std::string> solutions;
+    auto found = [&](Node &node) {
+        solutions.emplace_back(to_string(node));
+    };
+    search(startNodes, target, found, stats, everything);
+    return solutions;
+}
+
+std::vector<std::string> solve(std::vector<Node*> const &startNodes,
+                               int const target, SearchStats &stats)
+{
+    Exhaustive everything;
+    std::vector<std::string> solutions;
+    auto found = [&](Node &node) {
+        solutions.emplace_back(to_string(node));
+    };
+    search(startNodes, target, found, stats, everything);
+    return solutions;
+}
+
+template <typename OpSet>
+std::vector<std::string> solveWith(std::vector<Node*> const &startNodes, int const target)
+{
+    NoStats stats;
+    Exhaustive everything;
+    std::vector<std::string> solutions;
+    auto found = [&](Node &node) {
+        solutions.emplace_back(to_string(node));
+    };
+    search<OpSet>(startNodes, target, found, stats, everything);
+    return solutions;
+}
+
+template std::vector<std::string> solveWith<Standard>(std::vector<Node*> const &, int);
+template std::vector<std::string> solveWith<Extended>(std::vector<Node*> const &, int);
+
+// All solutions with k numbers have k-1 operations and are made by the first k-1
+// operations of the search, so deeper ones are never made. Hits with fewer numbers
+// are dropped before their string is made.
+std::vector<std::string> solveUsing(std::vector<Node*> const &startNodes, int const target,
+                                    std::size_t const k)
+{
+    std::vector<std::string> solutions;
+    if (k < 2 or k > std::size(startNodes)) return solutions;
+
+    auto found = [&](Node &node) {
+        if (static_cast<std::size_t>(numbersUsed(node)) == k) {
+            solutions.emplace_back(to_string(node));
+        }
+    };
+    NoStats stats;
+    DepthLimit limit{{}, k-1};
+    search(startNodes, target, found, stats, limit);
+    return solutions;
+}
+
+std::vector<std::string> solveUsing(std::vector<Node*> const &startNodes, int const target,
+                                    std::size_t const k, SearchStats &stats)
+{
+    std::vector<std::string> solutions;
+    if (k < 2 or k > std::size(startNodes)) return solutions;
+
+    auto found = [&](Node &node) {
+        if (static_cast<std::size_t>(numbersUsed(node)) == k) {
+            solutions.emplace_back(to_string(node));
+        }
+    };
+    DepthLimit limit{{}, k-1};
+    search(startNodes, target, found, stats, limit);
+    return solutions;
+}
+
+void forEachSolution(std::vector<Node*> const &startNodes, int const target,
+                     std::function<void(Node &)> const &found)
+{
+    NoStats stats;
+    Exhaustive everything;
+    search(startNodes, target, found, stats, everything);
+}
+
+std::size_t dedupCapacity(std::vector<Node*> const &startNodes, int const target)
+{
+    std::vector<int> numbers;
+    for (Node *node : startNodes) numbers.push_back(node->eval());
+    return std::max<std::size_t>(2 * countSolutions(numbers, target), 16);
+}
+
+std::vector<std::string> solveParallel(std::vector<Node*> const &startNodes,
+                                       int const target, unsigned const threads)
+{
+    Collector<std::string> collector(dedupCapacity(startNodes, target));
+    solveParallel(startNodes, target, threads, collector);
+    return distinctItems(collector);
+}
+
+std::vector<std::string> solveParallel(std::vector<Node*> const &startNodes,
+                                       int const target, unsigned const threads,
+                                       SearchStats &stats)
+{
+    Collector<std::string> collector(dedupCapacity(startNodes, target));
+    std::vector<SearchStats> threadStats;
+    parallelSearch(startNodes, target, threads, collector, threadStats);
+    for (auto const &s : threadStats) {
+        stats += s;
+    }
+    return distinctItems(collector);
+}
+
+void solveParallel(std::vector<Node*> const &startNodes, int const target,
+                   unsigned const threads, Collector<std::string> &collector)
+{
+    std::vector<NoStats> stats;
+    parallelSearch(startNodes, target, threads, collector, stats);
+}
+
+AnytimeResult solveUntil(std::vector<Node*> const &startNodes, int const target,
+                         std::chrono::steady_clock::time_point const deadline)
+{
+    NoStats stats;
+    Deadline watch(deadline, target);
+    AnytimeResult result;
+    auto found = [&](Node &node) {
+        result.solutions.emplace_back(to_string(node));
+    };
+    search(startNodes, target, found, stats, watch);
+
+    std::sort(std::begin(result.solutions), std::end(result.solutions));
+    result.solutions.erase(std::unique(std::begin(result.solutions), std::end(result.solutions)),
+                           std::end(result.solutions));
+    result.closest = std::move(watch.closest);
+    result.closestValue = watch.closestValue;
+    result.complete = not watch.stopped();
+    return result;
+}
+
+// Pass d makes all expressions with at most d operations. Every pass repeats all the
+// ones before it, but the number of nodes grows so fast with the depth that the
+// last pass takes most of the time anyway.
+Shallowest solveShallowest(std::vector<Node*> const &startNodes, int const target)
+{
+    Shallowest result;
+    NoStats stats;
+    auto found = [&](Node &node) {
+        result.solutions.emplace_back(to_string(node));
+    };
+    for (std::size_t operations = 1; operations < std::size(startNodes); ++operations) {
+        // no solution with fewer operations, so all hits have exactly this many
+        DepthLimit limit{{}, operations};
+        search(startNodes, target, found, stats, limit);
+        if (not std::empty(result.solutions)) {
+            result.operations = operations;
+            break;
+        }
+    }
+
+    std::sort(std::begin(result.solutions), std::end(result.solutions));
+    result.solutions.erase(std::unique(std::begin(result.solutions), std::end(result.solutions)),
+                           std::end(result.solutions));
+    return result;
+}
+
+// Instead of recursing, the search keeps one frame per depth on an explicit stack which
+// lives in the coroutine frame.
+Generator<std::string> lazySolve(std::vector<Node*> startNodes, int const target)
+{
+    if (std::size(startNodes) < 2) co_return;
+
+    // frames are reused and never reallocated, one per combination done so far
+    std::vector<Frame> frames(std::size(startNodes)-1);
+    frames[0].nodes = std::move(startNodes);
+    std::size_t depth = 0;
+
+    for (;;) {
+        Frame &frame = frames[depth];
+        auto const &nodes = frame.nodes;
+
+        if (frame.a == std::size(nodes)) {
+            // all pairs done, go back up
+            if (depth == 0) break;
+            --depth;
+            continue;
+        }
+        if (frame.b == std::size(nodes) or frame.op == std::size(ops)) {
+            // next pair
+            if (frame.b == std::size(nodes)) {
+                ++frame.a;
+                frame.b = 0;
+            }
+            else {
+                ++frame.b;
+            }
+            frame.op = 0;
+            continue;
+        }
+
+        Node * const nodea = nodes[frame.a];
+        Node * const nodeb = nodes[frame.b];
+        // only try every pair once: the order that is ok for sub
+        if (frame.a == frame.b or nodea->eval() <= nodeb->eval()) {
+            frame.op = std::size(ops);
+            continue;
+        }
+
+        auto const op = ops[frame.op++];
+        // skip divisions with remainder
+        if (op == Node::Kind::div and nodea->eval() % nodeb->eval() != 0) continue;
+
+        // make a new binary node
+        frame.opNode.emplace(op, nodea, nodeb);
+        if (frame.opNode->eval() == target) {
+            co_yield to_string(*frame.opNode);
+        }
+
+        // descend if enough nodes left, with a and b replaced by the new node
+        if (std::size(nodes) > 2) {
+            Frame &next = frames[depth+1];
+            next.nodes.clear();
+            for (std::size_t k = 0; k < std::size(nodes); ++k) {
+                if (k != frame.a and k != frame.b) next.nodes.push_back(nodes[k]);
+            }
+            next.nodes.push_back(&*frame.opNode);
+            next.a = next.b = next.op = 0;
+            ++depth;
+        }
+    }
+}
+
+}  // namespace countdown::raw
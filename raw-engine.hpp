@@ -0,0 +1,343 @@
+/*
+ * Tree search with raw pointers.
+ *
+ * Constructs a tree of operations, trying out all possible combinations.
+ * The solution contains duplicates in terms of associativity.
+ *
+ * This implementation uses raw pointers with memory managed from the outside of the
+ * solve function. It moves references around without counting them.
+ */
+
+#ifndef COUNTDOWN_RAW_ENGINE_HPP
+#define COUNTDOWN_RAW_ENGINE_HPP
+
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "collector.hpp"
+#include "generator.hpp"
+#include "search-stats.hpp"
+
+namespace countdown::raw {
+
+// base^exponent, -1 if it does not fit into an int
+constexpr int power(int const base, int const exponent) noexcept
+{
+    long long result = 1;
+    for (int i = 0; i < exponent; ++i) {
+        result *= base;
+        if (result > std::numeric_limits<int>::max()) return -1;
+    }
+    return static_cast<int>(result);
+}
+
+// The largest base whose power of each exponent fits into an int, up to 2^30, so a
+// power can be checked before it is computed.
+constexpr std::array<int, 31> maxPowerBase = [] {
+    std::array<int, 31> bases{};
+    for (int exponent = 2; exponent < std::ssize(bases); ++exponent) {
+        int low = 1, high = std::numeric_limits<int>::max() / 2;
+        while (low < high) {
+            int const mid = low + (high - low + 1) / 2;
+            if (power(mid, exponent) != -1) low = mid;
+            else high = mid - 1;
+        }
+        bases[exponent] = low;
+    }
+    return bases;
+}();
+static_assert(maxPowerBase[2] == 46340 and maxPowerBase[30] == 2);
+
+// the digits of a followed by the digits of b, -1 if that does not fit into an int
+constexpr int concatenate(int const a, int const b) noexcept
+{
+    constexpr long long most = std::numeric_limits<int>::max();
+    long long shift = 10;
+    while (shift <= b) shift *= 10;
+    if (a > most / shift) return -1;
+    long long const result = a * shift + b;
+    return result > most ? -1 : static_cast<int>(result);
+}
+
+struct Node
+{
+    enum Kind { val, sum, sub, mul, div, pow, cat };
+
+    Kind kind;
+
+private:
+    int value_{invalid_};
+    Node *a_{nullptr}, *b_{nullptr};
+
+    // cannot have negative number, use -1 as sentinel
+    constexpr static int invalid_ = -1;
+
+public:
+    explicit Node(int const number) noexcept
+        : kind{Kind::val}, value_{number}
+    { }
+
+    explicit Node(Kind const operation,
+                  Node *a, Node *b) noexcept
+        : kind{operation}, a_{a}, b_{b}
+    { }
+
+    int eval() noexcept
+    {
+        if (value_ == invalid_) {
+            switch (kind) {
+            case sum:
+                value_ = a_->eval() + b_->eval();
+                break;
+            case sub:
+                value_ = a_->eval() - b_->eval();
+                break;
+            case mul:
+                value_ = a_->eval() * b_->eval();
+                break;
+            case div:
+                value_ = a_->eval() / b_->eval();
+                break;
+            case pow:
+                value_ = power(a_->eval(), b_->eval());
+                break;
+            case cat:
+                value_ = concatenate(a_->eval(), b_->eval());
+                break;
+            default:
+                assert(false);
+            }
+        }
+
+        return value_;
+    }
+
+    Node *a() noexcept
+    {
+        return a_;
+    }
+
+    Node *b() noexcept
+    {
+        return b_;
+    }
+};
+
+// Operators of the search, each one makes nodes of one kind.
+// valid(a, b) says whether it may be applied to a and b, it is checked before the node
+// is made. Ordered operators are only tried with the larger operand first, which is
+// enough for the four standard ones. The others are tried in both orders, and also on
+// equal operands, which is only done if the set of operators has any of them.
+struct Add
+{
+    constexpr static Node::Kind kind = Node::sum;
+    constexpr static bool ordered = true;
+    static bool valid(Node &, Node &) noexcept { return true; }
+};
+
+struct Subtract
+{
+    constexpr static Node::Kind kind = Node::sub;
+    constexpr static bool ordered = true;
+    static bool valid(Node &, Node &) noexcept { return true; }
+};
+
+struct Multiply
+{
+    constexpr static Node::Kind kind = Node::mul;
+    constexpr static bool ordered = true;
+    static bool valid(Node &, Node &) noexcept { return true; }
+};
+
+struct Divide
+{
+    constexpr static Node::Kind kind = Node::div;
+    constexpr static bool ordered = true;
+    // no remainder
+    static bool valid(Node &a, Node &b) noexcept { return a.eval() % b.eval() == 0; }
+};
+
+// Add and Multiply that skip results that do not fit into an int. The numbers of the
+// show cannot get there with the standard operators, but with powers they can.
+struct CheckedAdd
+{
+    constexpr static Node::Kind kind = Node::sum;
+    constexpr static bool ordered = true;
+    static bool valid(Node &a, Node &b) noexcept
+    {
+        return static_cast<long long>(a.eval()) + b.eval() <= std::numeric_limits<int>::max();
+    }
+};
+
+struct CheckedMultiply
+{
+    constexpr static Node::Kind kind = Node::mul;
+    constexpr static bool ordered = true;
+    static bool valid(Node &a, Node &b) noexcept
+    {
+        return static_cast<long long>(a.eval()) * b.eval() <= std::numeric_limits<int>::max();
+    }
+};
+
+struct Power
+{
+    constexpr static Node::Kind kind = Node::pow;
+    constexpr static bool ordered = false;
+    // 1^n and n^1 make nothing new, and the result must fit into an int, which is
+    // checked on the operands so that only eval() computes the power
+    static bool valid(Node &a, Node &b) noexcept
+    {
+        return a.eval() > 1 and b.eval() > 1 and b.eval() < std::ssize(maxPowerBase)
+            and a.eval() <= maxPowerBase[static_cast<std::size_t>(b.eval())];
+    }
+};
+
+// digit concatenation, only of the numbers in the draw, 1 | 2 is 12
+struct Concatenate
+{
+    constexpr static Node::Kind kind = Node::cat;
+    constexpr static bool ordered = false;
+    static bool valid(Node &a, Node &b) noexcept
+    {
+        return a.kind == Node::val and b.kind == Node::val
+            and concatenate(a.eval(), b.eval()) != -1;
+    }
+};
+
+template <typename... Ops>
+struct Operators
+{
+    // some operator must be tried in both orders
+    constexpr static bool unordered = (not Ops::ordered or ...);
+};
+
+// the rules of the show
+using Standard = Operators<Add, Subtract, Multiply, Divide>;
+// the variant with powers and concatenation
+using Extended = Operators<CheckedAdd, Subtract, CheckedMultiply, Divide, Power, Concatenate>;
+
+std::string to_string(Node &node);
+
+// number of input numbers used
+int numbersUsed(Node &node);
+
+// turn numbers into vector of number nodes
+template <typename NS>
+auto toNodes(NS const &numbers)
+{
+    std::vector<std::unique_ptr<Node>> numberNodes;
+    for (int n : numbers) {
+        numberNodes.emplace_back(std::make_unique<Node>(n));
+    }
+    return numberNodes;
+}
+
+// the nodes without ownership, as solve expects them
+std::vector<Node*> toPointers(std::vector<std::unique_ptr<Node>> const &nodes);
+
+// print a collection of nodes
+template <typename NS>
+void printNodes(NS const &ns)
+{
+    for (auto &node : ns)
+        std::cout << to_string(*node) << '[' << node->eval() << ']' << "  ";
+    std::cout << '\n';
+}
+
+// Solve the game recursively.
+// Use a set of starting nodes and try all binary combinations.
+// The node memory must be maintained by the caller.
+std::vector<std::string> solve(std::vector<Node*> const &startNodes, int target);
+
+// like solve() but also add what the search does to stats
+std::vector<std::string> solve(std::vector<Node*> const &startNodes, int target,
+                               SearchStats &stats);
+
+// Like solve() but with another set of operators, e.g. solveWith<Extended>(...).
+// Defined for Standard and Extended, with Standard it is the same as solve().
+template <typename OpSet>
+std::vector<std::string> solveWith(std::vector<Node*> const &startNodes, int target);
+
+// Search like solve() but call found(node) for every node that evaluates to target
+// as soon as it is found. The node is only valid during the call.
+void forEachSolution(std::vector<Node*> const &startNodes, int target,
+                     std::function<void(Node &)> const &found);
+
+// Like solve() but only the solutions that use exactly k of the numbers.
+// The search never goes deeper than k-1 operations, so small k is much faster than
+// solve(), k = std::size(startNodes) is the must-use-all variant of the game.
+std::vector<std::string> solveUsing(std::vector<Node*> const &startNodes, int target,
+                                    std::size_t k);
+
+// like solveUsing() above but also add what the search does to stats, its hits
+// include those with fewer than k numbers
+std::vector<std::string> solveUsing(std::vector<Node*> const &startNodes, int target,
+                                    std::size_t k, SearchStats &stats);
+
+// Solve the game on several threads.
+// The first pair of operands is taken from a shared list, everything below it is
+// searched by the same thread. Solutions go into a lock-free collector that drops
+// duplicates, so the result is distinct but not sorted.
+std::vector<std::string> solveParallel(std::vector<Node*> const &startNodes,
+                                       int target, unsigned threads);
+
+// like solveParallel() above but also add what the search does to stats
+std::vector<std::string> solveParallel(std::vector<Node*> const &startNodes,
+                                       int target, unsigned threads, SearchStats &stats);
+
+// Slots for a collector to drop the duplicate solutions without filling up: twice the
+// number of distinct solutions, counted in a DP without building them.
+std::size_t dedupCapacity(std::vector<Node*> const &startNodes, int target);
+
+// Solve on several threads like above but put the solutions into collector,
+// which can be read while the search is running. Returns when the search is done.
+void solveParallel(std::vector<Node*> const &startNodes, int target, unsigned threads,
+                   Collector<std::string> &collector);
+
+struct AnytimeResult
+{
+    // the distinct solutions found in time, sorted
+    std::vector<std::string> solutions;
+    // the expression closest to the target found in time, the smaller one on ties,
+    // a solution if there are any, empty if no node was made
+    std::string closest;
+    int closestValue = 0;
+    // false if the search was cut short by the deadline
+    bool complete = false;
+};
+
+// Solve like solve() but stop when the deadline has passed and return what was found
+// so far. The clock is read every few thousand nodes, so the search overruns the
+// deadline by at most the time that takes (microseconds) plus sorting the solutions.
+AnytimeResult solveUntil(std::vector<Node*> const &startNodes, int target,
+                         std::chrono::steady_clock::time_point deadline);
+
+struct Shallowest
+{
+    // the distinct solutions with the fewest operations, sorted
+    std::vector<std::string> solutions;
+    // the number of operations of each of them, 0 if there is no solution
+    std::size_t operations = 0;
+};
+
+// Solve by iterative deepening: search all expressions with one operation, then all
+// with up to two, and so on, and stop after the first depth with a solution.
+// Much faster than solve() on draws with short solutions.
+Shallowest solveShallowest(std::vector<Node*> const &startNodes, int target);
+
+// Solve the game lazily, yield solutions one at a time in the same order as solve().
+// Nothing is searched until the next solution is requested, so callers can stop early
+// or interleave several searches on one thread.
+// The node memory must be maintained by the caller and outlive the generator.
+Generator<std::string> lazySolve(std::vector<Node*> startNodes, int target);
+
+}  // namespace countdown::raw
+
+#endif  // COUNTDOWN_RAW_ENGINE_HPP
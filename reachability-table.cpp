@@ -0,0 +1,175 @@
+#include "reachability-table.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "subset-levels.hpp"
+
+namespace countdown {
+
+namespace {
+    constexpr std::uint64_t pageSize = 4096;
+
+    std::uint64_t roundUp(std::uint64_t const n, std::uint64_t const to)
+    {
+        return (n + to - 1) / to * to;
+    }
+}
+
+TableKey tableKey(std::vector<int> const &numbers)
+{
+    if (std::size(numbers) > maxTableDraw) {
+        throw std::invalid_argument("draw has too many numbers for a table");
+    }
+    if (std::any_of(std::begin(numbers), std::end(numbers), [](int const n) { return n <= 0; })) {
+        throw std::invalid_argument("table draws only have positive numbers");
+    }
+    TableKey key{};
+    auto const begin = std::end(key.numbers) - std::size(numbers);
+    std::copy(std::begin(numbers), std::end(numbers), begin);
+    std::sort(begin, std::end(key.numbers));
+    return key;
+}
+
+void writeReachabilityTable(std::string const &path, std::vector<std::vector<int>> draws,
+                            int const cap, unsigned const threads)
+{
+    if (cap <= 0) {
+        throw std::invalid_argument("invalid table cap");
+    }
+
+    // one entry per distinct draw, in the order of the index
+    std::vector<TableKey> keys;
+    for (auto const &draw : draws) {
+        keys.push_back(tableKey(draw));
+    }
+    std::sort(std::begin(keys), std::end(keys));
+    keys.erase(std::unique(std::begin(keys), std::end(keys)), std::end(keys));
+    draws.clear();
+    for (auto const &key : keys) {
+        draws.emplace_back(std::find_if(std::begin(key.numbers), std::end(key.numbers),
+                                        [](int const n) { return n != 0; }),
+                           std::end(key.numbers));
+    }
+
+    TableHeader header{};
+    std::memcpy(header.magic, tableMagic, sizeof(header.magic));
+    header.version = tableVersion;
+    header.keySize = sizeof(TableKey);
+    header.cap = static_cast<std::uint32_t>(cap);
+    header.count = std::size(keys);
+    header.indexOffset = roundUp(sizeof(TableHeader), alignof(TableKey));
+    header.bitsetOffset = roundUp(header.indexOffset + header.count*sizeof(TableKey), pageSize);
+    // whole cache lines, so no bitset straddles more of them than needed
+    header.stride = roundUp((static_cast<std::uint64_t>(cap) + 7) / 8, 64);
+
+    auto const strideWords = header.stride / sizeof(ValueBitset::Word);
+    std::vector<ValueBitset::Word> bitsets(header.count * strideWords);
+    std::atomic<std::size_t> next{0};
+    auto const work = [&] {
+        for (std::size_t i = next++; i < std::size(draws); i = next++) {
+            auto const all = reachableSet(subsetBitsets(draws[i], std::max(cap, defaultCap)));
+            auto *const out = bitsets.data() + i*strideWords;
+            all.forEach([&](int const value) {
+                if (value < cap) {
+                    out[value / ValueBitset::wordBits] |= ValueBitset::Word{1} << (value % ValueBitset::wordBits);
+                }
+            });
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < levelWorkers(threads); ++t) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    auto const put = [&](void const *data, std::uint64_t const size) {
+        file.write(static_cast<char const*>(data), static_cast<std::streamsize>(size));
+    };
+    auto const padTo = [&](std::uint64_t const offset) {
+        std::vector<char> const zeros(offset - static_cast<std::uint64_t>(file.tellp()), 0);
+        put(zeros.data(), std::size(zeros));
+    };
+    put(&header, sizeof(header));
+    padTo(header.indexOffset);
+    put(keys.data(), std::size(keys)*sizeof(TableKey));
+    padTo(header.bitsetOffset);
+    put(bitsets.data(), std::size(bitsets)*sizeof(ValueBitset::Word));
+    if (not file) {
+        throw std::runtime_error("cannot write table " + path);
+    }
+}
+
+ReachabilityTable::ReachabilityTable(std::string const &path)
+{
+    int const fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open " + path + ": " + std::strerror(errno));
+    }
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 or static_cast<std::size_t>(info.st_size) < sizeof(TableHeader)) {
+        ::close(fd);
+        throw std::runtime_error(path + " is not a reachability table");
+    }
+    size_ = static_cast<std::size_t>(info.st_size);
+    data_ = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data_ == MAP_FAILED) {
+        data_ = nullptr;
+        throw std::runtime_error("cannot map " + path + ": " + std::strerror(errno));
+    }
+
+    auto const *const bytes = static_cast<unsigned char const*>(data_);
+    header_ = reinterpret_cast<TableHeader const*>(bytes);
+    if (std::memcmp(header_->magic, tableMagic, sizeof(tableMagic)) != 0
+        or header_->version != tableVersion or header_->keySize != sizeof(TableKey)
+        or header_->stride*8 < header_->cap
+        or header_->indexOffset + header_->count*sizeof(TableKey) > size_
+        or header_->bitsetOffset + header_->count*header_->stride > size_) {
+        ::munmap(data_, size_);
+        throw std::runtime_error(path + " is not a reachability table");
+    }
+    index_ = reinterpret_cast<TableKey const*>(bytes + header_->indexOffset);
+    bitsets_ = bytes + header_->bitsetOffset;
+}
+
+ReachabilityTable::~ReachabilityTable()
+{
+    ::munmap(data_, size_);
+}
+
+ValueBitset::Word const *ReachabilityTable::find(std::vector<int> const &numbers) const
+{
+    if (std::size(numbers) > maxTableDraw) return nullptr;
+
+    auto const key = tableKey(numbers);
+    auto const end = index_ + header_->count;
+    auto const it = std::lower_bound(index_, end, key);
+    if (it == end or *it != key) return nullptr;
+    return reinterpret_cast<ValueBitset::Word const*>(bitsets_ + (it-index_)*header_->stride);
+}
+
+std::optional<bool> ReachabilityTable::reachable(std::vector<int> const &numbers,
+                                                 int const target) const
+{
+    if (target < 0 or target >= cap()) return std::nullopt;
+    auto const *const words = find(numbers);
+    if (words == nullptr) return std::nullopt;
+    return (words[target / ValueBitset::wordBits] >> (target % ValueBitset::wordBits)) & 1u;
+}
+
+}  // namespace countdown
@@ -0,0 +1,111 @@
+/*
+ * Precomputed reachable values of many draws, read through a memory mapping.
+ *
+ * The file is
+ *   TableHeader
+ *   index: count TableKeys (the sorted numbers of each draw), in increasing order
+ *   bitsets: count bitsets of stride bytes each, in the same order as the index,
+ *            starting at a page boundary
+ * all in native byte order. Bit v of a bitset is set if v can be made from the draw
+ * with at least one operation, for v below the cap of the table. The draws are
+ * searched by the bitset engine, so like it a value that can only be made through
+ * intermediate results of max(cap, defaultCap) or more is missing: a set bit is always
+ * reachable, a clear one is only unreachable under that limit.
+ *
+ * Opening a table only maps it, a lookup is a binary search in the index and a read
+ * of one bit, all directly in the mapping. Only the pages that are touched are read.
+ */
+
+#ifndef COUNTDOWN_REACHABILITY_TABLE_HPP
+#define COUNTDOWN_REACHABILITY_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "value-bitset.hpp"
+
+namespace countdown {
+
+// draws in a table have at most this many numbers
+constexpr std::size_t maxTableDraw = 8;
+
+// The numbers of a draw in increasing order, padded with zeros at the front.
+// Numbers are positive, so the padding keeps shorter draws apart from longer ones.
+struct TableKey
+{
+    std::int32_t numbers[maxTableDraw];
+
+    auto operator<=>(TableKey const &) const = default;
+};
+
+// throws std::invalid_argument for draws with too many numbers or numbers that
+// are not positive, which would read as padding
+TableKey tableKey(std::vector<int> const &numbers);
+
+struct TableHeader
+{
+    char magic[8];
+    std::uint16_t version;
+    std::uint16_t keySize;
+    std::uint32_t cap;
+    std::uint64_t count;
+    std::uint64_t indexOffset;
+    std::uint64_t bitsetOffset;
+    // bytes per bitset
+    std::uint64_t stride;
+};
+
+constexpr char tableMagic[8] = {'C', 'D', 'R', 'E', 'A', 'C', 'H', '\0'};
+constexpr std::uint16_t tableVersion = 1;
+
+// Compute the reachable values below cap of all draws and write them to a table at path.
+// The search itself is the bitset engine with max(cap, defaultCap) as its limit.
+// Draws are computed on several threads (0 for all hardware threads).
+// Throws std::runtime_error if the file cannot be written.
+void writeReachabilityTable(std::string const &path, std::vector<std::vector<int>> draws,
+                            int cap, unsigned threads = 1);
+
+// A table file mapped read-only, lookups do not copy anything.
+class ReachabilityTable
+{
+    void *data_{nullptr};
+    std::size_t size_{0};
+    TableHeader const *header_{nullptr};
+    TableKey const *index_{nullptr};
+    unsigned char const *bitsets_{nullptr};
+
+public:
+    // throws std::runtime_error if the file cannot be mapped or is not a table
+    explicit ReachabilityTable(std::string const &path);
+
+    ReachabilityTable(ReachabilityTable const &) = delete;
+    ReachabilityTable &operator=(ReachabilityTable const &) = delete;
+
+    ~ReachabilityTable();
+
+    // number of draws
+    std::size_t size() const noexcept
+    {
+        return header_->count;
+    }
+
+    int cap() const noexcept
+    {
+        return static_cast<int>(header_->cap);
+    }
+
+    // the bits of the reachable values of a draw, nullptr if it is not in the table,
+    // throws std::invalid_argument like tableKey()
+    ValueBitset::Word const *find(std::vector<int> const &numbers) const;
+
+    // whether target is reachable, nothing if the draw is not in the table or
+    // target is not below the cap
+    std::optional<bool> reachable(std::vector<int> const &numbers, int target) const;
+};
+
+}  // namespace countdown
+
+#endif  // COUNTDOWN_REACHABILITY_TABLE_HPP
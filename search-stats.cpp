@@ -0,0 +1,35 @@
+#include "search-stats.hpp"
+
+#include <algorithm>
+
+namespace countdown {
+
+SearchStats &SearchStats::operator+=(SearchStats const &other)
+{
+    nodes += other.nodes;
+    if (std::size(nodesPerDepth) < std::size(other.nodesPerDepth)) {
+        nodesPerDepth.resize(std::size(other.nodesPerDepth));
+    }
+    for (std::size_t depth = 0; depth < std::size(other.nodesPerDepth); ++depth) {
+        nodesPerDepth[depth] += other.nodesPerDepth[depth];
+    }
+    orderRejected += other.orderRejected;
+    remainderRejected += other.remainderRejected;
+    hits += other.hits;
+    duplicates += other.duplicates;
+    return *this;
+}
+
+void print(std::ostream &os, SearchStats const &stats)
+{
+    os << "Nodes: " << stats.nodes << '\n';
+    for (std::size_t depth = 0; depth < std::size(stats.nodesPerDepth); ++depth) {
+        os << "  at depth " << depth << ": " << stats.nodesPerDepth[depth] << '\n';
+    }
+    os << "Pairs rejected by order: " << stats.orderRejected << '\n';
+    os << "Divisions rejected for remainder: " << stats.remainderRejected << '\n';
+    os << "Target hits: " << stats.hits << '\n';
+    os << "Solutions lost to dedup: " << stats.duplicates << '\n';
+}
+
+}  // namespace countdown
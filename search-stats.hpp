@@ -0,0 +1,74 @@
+/*
+ * Counters for what a tree search does.
+ *
+ * The engines take the counters as a template parameter. Searches without counters
+ * use NoStats whose members do nothing, so they compile to the same code as before.
+ * The counters only watch. What cuts a search short, like a deadline or a depth
+ * limit, is a separate policy parameter of the raw pointer search (raw-engine.cpp).
+ */
+
+#ifndef COUNTDOWN_SEARCH_STATS_HPP
+#define COUNTDOWN_SEARCH_STATS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace countdown {
+
+struct SearchStats
+{
+    // expression nodes made
+    std::uint64_t nodes = 0;
+    // nodes made at every depth, depth 0 combines two of the input numbers
+    std::vector<std::uint64_t> nodesPerDepth;
+    // pairs skipped because the first operand was not larger than the second
+    std::uint64_t orderRejected = 0;
+    // divisions skipped because of a remainder
+    std::uint64_t remainderRejected = 0;
+    // nodes that evaluate to the target
+    std::uint64_t hits = 0;
+    // hits that were dropped because another hit had the same expression
+    std::uint64_t duplicates = 0;
+
+    void node(std::size_t const depth)
+    {
+        ++nodes;
+        if (depth >= std::size(nodesPerDepth)) nodesPerDepth.resize(depth+1);
+        ++nodesPerDepth[depth];
+    }
+
+    void orderReject() noexcept
+    {
+        ++orderRejected;
+    }
+
+    void remainderReject() noexcept
+    {
+        ++remainderRejected;
+    }
+
+    void hit() noexcept
+    {
+        ++hits;
+    }
+
+    SearchStats &operator+=(SearchStats const &other);
+};
+
+// counts nothing
+struct NoStats
+{
+    void node(std::size_t) noexcept { }
+    void orderReject() noexcept { }
+    void remainderReject() noexcept { }
+    void hit() noexcept { }
+};
+
+// one counter per line
+void print(std::ostream &os, SearchStats const &stats);
+
+}  // namespace countdown
+
+#endif  // COUNTDOWN_SEARCH_STATS_HPP
@@ -0,0 +1,460 @@
+/*
+ * Solve the numbers game from the TV show countdown.
+ *
+ * Long running solver that answers requests over a Unix domain socket,
+ * see protocol.hpp for the format.
+ * This avoids starting a process for every query and keeps what previous queries found:
+ * the solutions for each draw and target (transposition table) and the reachable
+ * values of each draw (draw table). Requests are answered by a pool of -j threads, at
+ * most 256 connections are open at once.
+ * Draws have at most 6 numbers for the tree engines and at most 8 for the others, and
+ * requests may use at most -j threads (0 means -j).
+ * Both tables evict the least recently used entries when they have more than -c entries
+ * or use more than half of -m MiB each. With -m, a draw whose solutions do not fit
+ * keeps only a sample of them, see capped-solve.hpp.
+ *
+ * Usage: countdown-server [-j threads] [-c cache entries] [-m memory MiB] socket-path
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <map>
+#include <list>
+#include <deque>
+#include <set>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <thread>
+#include <atomic>
+#include <csignal>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "capped-solve.hpp"
+#include "countdown.hpp"
+#include "protocol.hpp"
+
+using namespace countdown;
+
+// Results by key, computed on first use and kept until the cache is over capacity
+// entries or budget bytes. The least recently used entries are evicted first.
+template <typename Value>
+class Cache
+{
+    using Key = std::vector<int>;
+
+    struct Entry
+    {
+        std::shared_ptr<Value const> value;
+        std::size_t bytes;
+        // position in order_
+        std::list<Key>::iterator used;
+    };
+
+    std::mutex mutex_;
+    std::map<Key, Entry> entries_;
+    // most recently used first
+    std::list<Key> order_;
+    std::size_t const capacity_;
+    std::size_t const budget_;
+    std::size_t bytes_{0};
+    std::size_t evicted_{0};
+
+public:
+    Cache(std::size_t const capacity, std::size_t const budget)
+        : capacity_{capacity}, budget_{budget}
+    { }
+
+    // The value for key, compute() makes it if it is not in the cache.
+    // compute runs without holding the lock, so two threads may compute the same key.
+    template <typename F>
+    std::shared_ptr<Value const> get(Key const &key, F &&compute)
+    {
+        {
+            std::lock_guard lock{mutex_};
+            if (auto const it = entries_.find(key); it != std::end(entries_)) {
+                order_.splice(std::begin(order_), order_, it->second.used);
+                return it->second.value;
+            }
+        }
+
+        auto value = std::make_shared<Value const>(compute());
+        std::size_t const bytes = footprint(key) + footprint(*value);
+
+        std::lock_guard lock{mutex_};
+        auto const [it, inserted] = entries_.try_emplace(key, Entry{value, bytes, {}});
+        if (inserted) {
+            order_.push_front(key);
+            it->second.used = std::begin(order_);
+            bytes_ += bytes;
+            // never evict the new entry, the caller gets it in any case
+            while (std::size(order_) > 1
+                   and (std::size(order_) > capacity_ or bytes_ > budget_)) {
+                auto const last = entries_.find(order_.back());
+                bytes_ -= last->second.bytes;
+                entries_.erase(last);
+                order_.pop_back();
+                ++evicted_;
+            }
+        }
+        return it->second.value;
+    }
+
+    // number of entries evicted so far
+    std::size_t evicted()
+    {
+        std::lock_guard lock{mutex_};
+        return evicted_;
+    }
+
+private:
+    static std::size_t footprint(std::vector<int> const &values)
+    {
+        return sizeof(values) + values.capacity() * sizeof(int);
+    }
+
+    static std::size_t footprint(CappedSolutions const &capped)
+    {
+        return sizeof(capped) + countdown::footprint(capped.solutions);
+    }
+};
+
+// Draws are cached by their sorted numbers, the order does not change any result.
+std::vector<int> drawKey(protocol::Request const &request, bool const withTarget)
+{
+    std::vector<int> key = request.numbers;
+    std::sort(std::begin(key), std::end(key));
+    key.push_back(static_cast<int>(request.engine));
+    if (withTarget) key.push_back(request.target);
+    return key;
+}
+
+class Solver
+{
+    // solutions of draw and target
+    Cache<CappedSolutions> solutions_;
+    // reachable values of a draw
+    Cache<std::vector<int>> tables_;
+    // most memory for the solutions of a single draw, unlimited if max
+    std::size_t const solveBudget_;
+    static constexpr std::size_t unlimited = std::numeric_limits<std::size_t>::max();
+    // most threads for one request
+    unsigned const threads_;
+
+public:
+    // budget is split evenly between the two caches
+    Solver(std::size_t const capacity, std::size_t const budget, unsigned const threads)
+        : solutions_{capacity, budget / 2}, tables_{capacity, budget / 2},
+          solveBudget_{budget == unlimited ? unlimited : budget / 2}, threads_{threads}
+    { }
+
+    // number of cache entries evicted to stay within capacity or budget
+    std::size_t evicted()
+    {
+        return solutions_.evicted() + tables_.evicted();
+    }
+
+    protocol::Response handle(protocol::Request const &request)
+    {
+        protocol::Response response;
+        response.op = request.op;
+
+        // the tree search grows exponentially with the numbers, 6 take a few 10ms,
+        // the value engines and counting stay fast a bit longer
+        bool const enumerates = request.op == protocol::Op::solve
+            or request.engine == Engine::raw or request.engine == Engine::shared;
+        std::size_t const maxNumbers = enumerates ? 6 : 8;
+        if (std::empty(request.numbers) or std::size(request.numbers) > maxNumbers
+            or std::any_of(std::begin(request.numbers), std::end(request.numbers),
+                           [](int const n) { return n <= 0; })) {
+            response.error = "invalid draw";
+            return response;
+        }
+
+        if (request.threads > threads_) {
+            response.error = "too many threads";
+            return response;
+        }
+
+        Options options;
+        options.engine = request.engine;
+        options.threads = request.threads == 0 ? threads_ : request.threads;
+
+        try {
+            switch (request.op) {
+            case protocol::Op::solve:
+            case protocol::Op::count: {
+                auto const sols = solutions_.get(drawKey(request, true), [&] {
+                    return solveWithin(request.numbers, request.target, options);
+                });
+                if (request.op == protocol::Op::solve) response.solutions = sols->solutions;
+                response.count = sols->count;
+                break;
+            }
+            case protocol::Op::nearest:
+            case protocol::Op::reachable: {
+                auto const table = tables_.get(drawKey(request, false), [&] {
+                    return reachable(request.numbers, options);
+                });
+                if (request.op == protocol::Op::reachable) {
+                    response.values = *table;
+                }
+                else {
+                    response.value = nearestIn(*table, request.target);
+                }
+                break;
+            }
+            }
+        }
+        catch (std::exception const &e) {
+            response.error = e.what();
+        }
+        return response;
+    }
+
+private:
+    // With a memory budget, the raw engine keeps only a sample of the solutions if they
+    // do not fit, on one thread. Other engines and unlimited servers solve as requested.
+    CappedSolutions solveWithin(std::vector<int> const &numbers, int const target,
+                                Options const &options) const
+    {
+        bool const capped = solveBudget_ != unlimited
+            and (options.engine == Engine::automatic or options.engine == Engine::raw);
+        if (capped) return solveCapped(numbers, target, solveBudget_);
+
+        CappedSolutions all;
+        all.solutions = solve(numbers, target, options);
+        all.count = std::size(all.solutions);
+        return all;
+    }
+
+    // same as countdown::nearest but on a sorted list of reachable values
+    static int nearestIn(std::vector<int> const &values, int const target)
+    {
+        auto const it = std::lower_bound(std::begin(values), std::end(values), target);
+        if (it == std::end(values)) return std::empty(values) ? 0 : values.back();
+        if (*it == target or it == std::begin(values)) return *it;
+        int const below = *std::prev(it);
+        return target - below <= *it - target ? below : *it;
+    }
+};
+
+// Runs requests on a fixed number of worker threads. Every connection has a thread of
+// its own that only reads a request, queues it, waits for a worker to answer it, and
+// writes the response, so open connections that are idle hold no worker and a cache
+// hit never waits for another client to hang up. Requests of one connection are
+// answered in order. At most maxConnections connections are served at once, further
+// ones are closed right away.
+class ConnectionPool
+{
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::packaged_task<protocol::Response()>> requests_;
+    // reader thread of every open connection by its socket
+    std::map<int, std::thread> connections_;
+    // connections whose reader is done, to be joined and closed
+    std::vector<int> finished_;
+    bool stopping_{false};
+    std::vector<std::thread> workers_;
+    Solver &solver_;
+
+    void serve(int const fd)
+    {
+        std::vector<std::uint8_t> payload;
+        try {
+            while (protocol::readFrame(fd, payload)) {
+                std::packaged_task<protocol::Response()> task([this, payload] {
+                    protocol::Response response;
+                    try {
+                        response = solver_.handle(protocol::decodeRequest(payload));
+                    }
+                    catch (std::runtime_error const &e) {
+                        // malformed request, the op may be garbage as well
+                        response.error = e.what();
+                    }
+                    return response;
+                });
+                auto response = task.get_future();
+                {
+                    std::lock_guard lock{mutex_};
+                    if (stopping_) break;
+                    requests_.push_back(std::move(task));
+                }
+                cv_.notify_one();
+                // throws std::future_error if the server stops before answering
+                protocol::writeFrame(fd, protocol::encode(response.get()));
+            }
+        }
+        catch (std::exception const &e) {
+            std::lock_guard lock{mutex_};
+            if (not stopping_) std::cerr << "connection: " << e.what() << '\n';
+        }
+
+        std::lock_guard lock{mutex_};
+        finished_.push_back(fd);
+    }
+
+    void work()
+    {
+        for (;;) {
+            std::packaged_task<protocol::Response()> task;
+            {
+                std::unique_lock lock{mutex_};
+                cv_.wait(lock, [&] { return stopping_ or not std::empty(requests_); });
+                if (stopping_) return;
+                task = std::move(requests_.front());
+                requests_.pop_front();
+            }
+            task();
+        }
+    }
+
+    // join the readers of closed connections, mutex_ must be held
+    void reap()
+    {
+        for (int const fd : finished_) {
+            auto const it = connections_.find(fd);
+            it->second.join();
+            connections_.erase(it);
+            ::close(fd);
+        }
+        finished_.clear();
+    }
+
+public:
+    constexpr static std::size_t maxConnections = 256;
+
+    ConnectionPool(unsigned const nthreads, Solver &solver)
+        : solver_{solver}
+    {
+        for (unsigned i = 0; i < nthreads; ++i) {
+            workers_.emplace_back([this] { work(); });
+        }
+    }
+
+    ~ConnectionPool()
+    {
+        {
+            std::lock_guard lock{mutex_};
+            stopping_ = true;
+            // wake up readers blocked on their clients
+            for (auto const &[fd, reader] : connections_) {
+                ::shutdown(fd, SHUT_RDWR);
+            }
+        }
+        cv_.notify_all();
+        for (auto &worker : workers_) {
+            worker.join();
+        }
+
+        std::unique_lock lock{mutex_};
+        // readers waiting for these get a broken promise
+        requests_.clear();
+        while (not std::empty(connections_)) {
+            reap();
+            if (std::empty(connections_)) break;
+            lock.unlock();
+            std::this_thread::yield();
+            lock.lock();
+        }
+    }
+
+    void add(int const fd)
+    {
+        std::lock_guard lock{mutex_};
+        reap();
+        if (std::size(connections_) >= maxConnections) {
+            std::cerr << "too many connections, closing a new one\n";
+            ::close(fd);
+            return;
+        }
+        connections_.emplace(fd, std::thread([this, fd] { serve(fd); }));
+    }
+};
+
+std::atomic<bool> stopRequested{false};
+
+extern "C" void onSignal(int)
+{
+    stopRequested = true;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t capacity = 10000;
+    std::size_t budget = std::numeric_limits<std::size_t>::max();
+    std::string path;
+    for (int i = 1; i < argc; ++i) {
+        std::string const arg = argv[i];
+        if (arg == "-j" and i+1 < argc) {
+            threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        }
+        else if (arg == "-c" and i+1 < argc) {
+            capacity = std::stoul(argv[++i]);
+        }
+        else if (arg == "-m" and i+1 < argc) {
+            budget = std::stoul(argv[++i]) << 20;
+        }
+        else {
+            path = arg;
+        }
+    }
+    if (path.empty() or threads == 0) {
+        std::cerr << "Usage: countdown-server [-j threads] [-c cache entries] [-m memory MiB] socket-path\n";
+        return 1;
+    }
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (std::size(path) >= sizeof(address.sun_path)) {
+        std::cerr << "socket path too long\n";
+        return 1;
+    }
+    std::strcpy(address.sun_path, path.c_str());
+
+    int const listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ::unlink(path.c_str());
+    if (listener < 0
+        or ::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        or ::listen(listener, 64) != 0) {
+        std::cerr << "cannot listen on " << path << ": " << std::strerror(errno) << '\n';
+        return 1;
+    }
+
+    // no SA_RESTART, so that accept returns when we are asked to stop
+    struct sigaction action{};
+    action.sa_handler = onSignal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    std::cout << "Listening on " << path << " with " << threads << " threads\n" << std::flush;
+
+    {
+        Solver solver{capacity, budget, threads};
+        ConnectionPool pool{threads, solver};
+        while (not stopRequested) {
+            int const fd = ::accept(listener, nullptr, nullptr);
+            if (fd < 0) {
+                if (errno == EINTR) continue;
+                std::cerr << "accept: " << std::strerror(errno) << '\n';
+                break;
+            }
+            pool.add(fd);
+        }
+        std::cout << "Evicted " << solver.evicted() << " cache entries\n";
+    }
+
+    ::close(listener);
+    ::unlink(path.c_str());
+}
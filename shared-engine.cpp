@@ -0,0 +1,120 @@
+#include "shared-engine.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace countdown::shared {
+
+int add(int const a, int const b)
+{
+    return a + b;
+}
+
+int sub(int const a, int const b)
+{
+    return a - b;
+}
+
+int mul(int const a, int const b)
+{
+    return a * b;
+}
+
+// div is already used
+int rat(int const a, int const b)
+{
+    return a / b;
+}
+
+std::array ops{add, sub, mul, rat};
+
+// turn operation into string
+std::string str(Operation const &op)
+{
+    if (op == add) {
+        return std::string("+");
+    }
+    if (op == sub) {
+        return std::string("-");
+    }
+    if (op == mul) {
+        return std::string("*");
+    }
+    if (op == rat) {
+        return std::string("/");
+    }
+    return std::string("?");
+}
+
+namespace {
+    // Recurse with a vector with two nodes erased and one extra node for the new operation.
+    template <typename Stats>
+    std::vector<NodePtr> search(std::vector<NodePtr> const &startNodes,
+                                int const target, Stats &stats, std::size_t const depth = 0)
+    {
+        std::vector<NodePtr> solutions;
+
+        for (auto op : ops) {
+            for (size_t i = 0; i < startNodes.size(); ++i) {
+                // first operand to try
+                NodePtr const &nodei = startNodes[i];
+                // new vector without nodei
+                std::vector<NodePtr> auxNodes(startNodes);
+                auxNodes.erase(std::begin(auxNodes)+i);
+
+                for (size_t j = 0; j < auxNodes.size(); ++j) {
+                    // second operand to try
+                    NodePtr const &nodej = auxNodes[j];
+
+                    // only try every pair once: the order that is ok for sub
+                    if (nodei->eval() <= nodej->eval()) {
+                        stats.orderReject();
+                        continue;
+                    }
+                    // skip divisions with remainder
+                    if (op == rat and nodei->eval() % nodej->eval() != 0) {
+                        stats.remainderReject();
+                        continue;
+                    }
+
+                    // new vector without nodei and nodej
+                    std::vector<NodePtr> newNodes(auxNodes);
+                    newNodes.erase(std::begin(newNodes)+j);
+
+                    // make a new binary node
+                    auto n = std::make_shared<Binary>(op, nodei, nodej);
+                    stats.node(depth);
+                    if (n->eval() == target) {
+                        stats.hit();
+                        solutions.emplace_back(n);
+                    }
+                    newNodes.emplace_back(std::move(n));
+
+                    // printNodes(newNodes);
+
+                    // recurse if enough nodes left
+                    if (std::size(newNodes) > 1) {
+                        auto const sols = search(newNodes, target, stats, depth+1);
+                        std::copy(std::begin(sols), std::end(sols), std::back_inserter(solutions));
+                    }
+                }
+            }
+        }
+
+        return solutions;
+    }
+}
+
+std::vector<NodePtr> solve(std::vector<NodePtr> const &startNodes, int const target)
+{
+    NoStats stats;
+    return search(startNodes, target, stats);
+}
+
+std::vector<NodePtr> solve(std::vector<NodePtr> const &startNodes, int const target,
+                           SearchStats &stats)
+{
+    return search(startNodes, target, stats);
+}
+
+}  // namespace countdown::shared
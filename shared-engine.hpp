@@ -0,0 +1,132 @@
+/*
+ * Tree search with shared pointers.
+ *
+ * Constructs a tree of operations, trying out all possible combinations.
+ * The solution contains duplicates in terms of associativity.
+ *
+ * This implementation uses shared pointers to pass references around in the call stack of
+ * solve.
+ */
+
+#ifndef COUNTDOWN_SHARED_ENGINE_HPP
+#define COUNTDOWN_SHARED_ENGINE_HPP
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "search-stats.hpp"
+
+namespace countdown::shared {
+
+// functions for all operations
+using Operation = int(*)(int, int);
+
+int add(int a, int b);
+int sub(int a, int b);
+int mul(int a, int b);
+// div is already used
+int rat(int a, int b);
+
+// turn operation into string
+std::string str(Operation const &op);
+
+
+// abstract base for nodes
+struct Node
+{
+    virtual ~Node() = default;
+    virtual int eval() = 0;
+    virtual std::string str() = 0;
+};
+// yeah, yeah, it is easiest to use here...
+using NodePtr = std::shared_ptr<Node>;
+
+// just a number
+struct Number : Node
+{
+    int number;
+
+    explicit Number(int n) : number{n} { }
+    ~Number() override = default;
+
+    int eval() override
+    {
+        return number;
+    }
+
+    std::string str() override
+    {
+        return std::to_string(number);
+    }
+};
+
+// binary operation
+struct Binary : Node
+{
+private:
+    // memoise the value
+    int value_ = invalid;
+    // memoise string
+    std::string s_{};
+
+    // cannot have negative number, use -1 as sentinel
+    constexpr static int invalid = -1;
+
+public:
+    Operation op;
+    NodePtr a, b;  // operands
+
+    explicit Binary(Operation op, NodePtr a, NodePtr b)
+        : op{op}, a{a}, b{b} { }
+    ~Binary() override = default;
+
+    int eval() override
+    {
+        if (value_ == invalid) {
+            value_ = op(a->eval(), b->eval());
+        }
+        return value_;
+    }
+
+    std::string str() override
+    {
+        if (s_.empty()) {
+            s_ = '('+a->str()+' '+shared::str(op)+' '+b->str()+')';
+        }
+        return s_;
+    }
+};
+
+// turn numbers into vector of number nodes
+template <typename NS>
+auto toNodes(NS const &numbers)
+{
+    std::vector<NodePtr> numberNodes;
+    for (int n : numbers) {
+        numberNodes.emplace_back(std::make_shared<Number>(n));
+    }
+    return numberNodes;
+}
+
+// print a collection of nodes
+template <typename NS>
+void printNodes(NS const &ns)
+{
+    for (auto &node : ns)
+        std::cout << node->str() << '[' << node->eval() << ']' << "  ";
+    std::cout << '\n';
+}
+
+// Solve the game recursively.
+// Use a set of starting nodes and try all binary combinations.
+std::vector<NodePtr> solve(std::vector<NodePtr> const &startNodes, int target);
+
+// like solve() but also add what the search does to stats
+std::vector<NodePtr> solve(std::vector<NodePtr> const &startNodes, int target,
+                           SearchStats &stats);
+
+}  // namespace countdown::shared
+
+#endif  // COUNTDOWN_SHARED_ENGINE_HPP
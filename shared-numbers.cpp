@@ -11,199 +11,30 @@
  *
  * This implementation uses shared pointers to pass references around in the call stack of
  * solve.
+ *
+ * Run with --stats to print counters of the search next to the timings.
+ * Build with -DCOUNTDOWN_TRACK_ALLOCATIONS=ON to also print the allocations of the
+ * search, the clean up, and printing the solutions.
  */
 
 #include <iostream>
 #include <vector>
-#include <memory>
 #include <array>
-#include <string>
 #include <algorithm>
 #include <chrono>
+#include <string>
 
-// functions for all operations
-using Operation = int(*)(int, int);
-
-int add(int const a, int const b)
-{
-    return a + b;
-}
-
-int sub(int const a, int const b)
-{
-    return a - b;
-}
-
-int mul(int const a, int const b)
-{
-    return a * b;
-}
-
-// div is already used
-int rat(int const a, int const b)
-{
-    return a / b;
-}
-
-std::array ops{add, sub, mul, rat};
-
-// turn operation into string
-std::string str(Operation const &op)
-{
-    if (op == add) {
-        return std::string("+");
-    }
-    if (op == sub) {
-        return std::string("-");
-    }
-    if (op == mul) {
-        return std::string("*");
-    }
-    if (op == rat) {
-        return std::string("/");
-    }
-    return std::string("?");
-}
-
-
-// abstract base for nodes
-struct Node
-{
-    virtual ~Node() = default;
-    virtual int eval() = 0;
-    virtual std::string str() = 0;
-};
-// yeah, yeah, it is easiest to use here...
-using NodePtr = std::shared_ptr<Node>;
-
-// just a number
-struct Number : Node
-{
-    int number;
-
-    explicit Number(int n) : number{n} { }
-    ~Number() override = default;
-
-    int eval() override
-    {
-        return number;
-    }
-
-    std::string str() override
-    {
-        return std::to_string(number);
-    }
-};
-
-// binary operation
-struct Binary : Node
-{
-private:
-    // memoise the value
-    int value_ = invalid;
-    // memoise string
-    std::string s_{};
-
-    // cannot have negative number, use -1 as sentinel
-    constexpr static int invalid = -1;
-
-public:
-    Operation op;
-    NodePtr a, b;  // operands
-
-    explicit Binary(Operation op, NodePtr a, NodePtr b)
-        : op{op}, a{a}, b{b} { }
-    ~Binary() override = default;
-
-    int eval() override
-    {
-        if (value_ == invalid) {
-            value_ = op(a->eval(), b->eval());
-        }
-        return value_;
-    }
-
-    std::string str() override
-    {
-        if (s_.empty()) {
-            s_ = '('+a->str()+' '+::str(op)+' '+b->str()+')';
-        }
-        return s_;
-    }
-};
+#include "alloc-tracker.hpp"
+#include "shared-engine.hpp"
 
-// turn array into vector of number nodes
-template <size_t N>
-auto toNodes(std::array<int, N> const &numbers)
-{
-    std::vector<NodePtr> numberNodes;
-    for (int n : numbers) {
-        numberNodes.emplace_back(std::make_shared<Number>(n));
-    }
-    return numberNodes;
-}
+using namespace countdown;
+using namespace countdown::shared;
 
-// print a collection of nodes
-template <typename NS>
-void printNodes(NS const &ns)
+int main(int argc, char *argv[])
 {
-    for (auto &node : ns)
-        std::cout << node->str() << '[' << node->eval() << ']' << "  ";
-    std::cout << '\n';
-}
+    // count what the search does, --stats
+    bool const withStats = argc > 1 and std::string(argv[1]) == "--stats";
 
-// Solve the game recursively.
-// Use a set of starting nodes and try all binary combinations.
-// Recurse with a vector with two nodes erased and one extra node for the new operation.
-std::vector<NodePtr> solve(std::vector<NodePtr> const &startNodes,
-                           int const target)
-{
-    std::vector<NodePtr> solutions;
-
-    for (auto op : ops) {
-        for (size_t i = 0; i < startNodes.size(); ++i) {
-            // first operand to try
-            NodePtr const &nodei = startNodes[i];
-            // new vector without nodei
-            std::vector<NodePtr> auxNodes(startNodes);
-            auxNodes.erase(std::begin(auxNodes)+i);
-
-            for (size_t j = 0; j < auxNodes.size(); ++j) {
-                // second operand to try
-                NodePtr const &nodej = auxNodes[j];
-
-                // only try every pair once: the order that is ok for sub
-                if (nodei->eval() <= nodej->eval()) continue;
-                // skip divisions with remainder
-                if (op == rat and nodei->eval() % nodej->eval() != 0) continue;
-
-                // new vector without nodei and nodej
-                std::vector<NodePtr> newNodes(auxNodes);
-                newNodes.erase(std::begin(newNodes)+j);
-
-                // make a new binary node
-                auto n = std::make_shared<Binary>(op, nodei, nodej);
-                if (n->eval() == target) {
-                    solutions.emplace_back(n);
-                }
-                newNodes.emplace_back(std::move(n));
-
-                // printNodes(newNodes);
-
-                // recurse if enough nodes left
-                if (std::size(newNodes) > 1) {
-                    auto const sols = solve(newNodes, target);
-                    std::copy(std::begin(sols), std::end(sols), std::back_inserter(solutions));
-                }
-            }
-        }
-    }
-
-    return solutions;
-}
-
-int main()
-{
     // the number we want to get
     constexpr int target = 784;
     // the input numbers
@@ -216,12 +47,17 @@ int main()
     std::cout << '\n';
 
     // solve
+    AllocStats allocsSol, allocsUnique, allocsPrint;
+    if constexpr (trackAllocations) resetAllocStats();
     auto startTimeSol = std::chrono::steady_clock::now();
-    auto solutions = solve(numberNodes, target);
+    SearchStats stats;
+    auto solutions = withStats ? solve(numberNodes, target, stats) : solve(numberNodes, target);
     auto endTimeSol = std::chrono::steady_clock::now();
+    if constexpr (trackAllocations) allocsSol = allocStats();
     std::cout << '\n';
 
     // erase all duplicates
+    if constexpr (trackAllocations) resetAllocStats();
     auto startTimeUnique = std::chrono::steady_clock::now();
     std::sort(std::begin(solutions), std::end(solutions),
               [](NodePtr const &n1, NodePtr const &n2) {
@@ -233,10 +69,14 @@ int main()
                                 }),
                     std::end(solutions));
     auto endTimeUnique = std::chrono::steady_clock::now();
+    if constexpr (trackAllocations) allocsUnique = allocStats();
+    stats.duplicates = stats.hits - std::size(solutions);
 
+    if constexpr (trackAllocations) resetAllocStats();
     std::cout << "Solutions:\n";
     for (auto &node : solutions)
         std::cout << node->str() << " [" << node->eval() << "]\n";
+    if constexpr (trackAllocations) allocsPrint = allocStats();
 
     std::cout << '\n';
     std::cout << "Time to solution: "
@@ -245,4 +85,17 @@ int main()
     std::cout << "Time to clean up: "
               << std::chrono::duration_cast<std::chrono::milliseconds>(endTimeUnique-startTimeUnique).count()
               << "ms\n";
+    if constexpr (trackAllocations) {
+        std::cout << "Allocations to solution: ";
+        print(std::cout, allocsSol);
+        std::cout << "\nAllocations to clean up: ";
+        print(std::cout, allocsUnique);
+        std::cout << "\nAllocations to print: ";
+        print(std::cout, allocsPrint);
+        std::cout << '\n';
+    }
+    if (withStats) {
+        std::cout << '\n';
+        print(std::cout, stats);
+    }
 }
@@ -0,0 +1,176 @@
+#include "solution-count.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+namespace countdown {
+
+namespace {
+    // values to keep, both inclusive
+    struct Window
+    {
+        int lowest;
+        int highest;
+
+        bool contains(std::int64_t const value) const noexcept
+        {
+            return value >= lowest and value <= highest;
+        }
+    };
+
+    // Add the counts of all trees made from a tree in a and a tree in b to out if their
+    // value is in window, a tree from a goes first and must have the larger value.
+    void combineCounts(ValueCounts const &a, ValueCounts const &b, Window const window,
+                       ValueCounts &out)
+    {
+        for (auto const &[x, cx] : a) {
+            for (auto const &[y, cy] : b) {
+                // only try every pair once: the order that is ok for sub
+                if (y >= x) break;
+                std::uint64_t const c = cx * cy;
+
+                if (window.contains(x + y)) out.emplace_back(x + y, c);
+                if (window.contains(x - y)) out.emplace_back(x - y, c);
+                if (window.contains(static_cast<std::int64_t>(x) * y)) out.emplace_back(x * y, c);
+                // skip divisions with remainder
+                if (x % y == 0 and window.contains(x / y)) out.emplace_back(x / y, c);
+            }
+        }
+    }
+
+    // sort by value and add up the counts of equal values
+    void merge(ValueCounts &counts)
+    {
+        std::sort(std::begin(counts), std::end(counts),
+                  [](auto const &l, auto const &r) { return l.first < r.first; });
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < std::size(counts); ++i) {
+            if (n > 0 and counts[n-1].first == counts[i].first) {
+                counts[n-1].second += counts[i].second;
+            }
+            else {
+                counts[n++] = counts[i];
+            }
+        }
+        counts.resize(n);
+    }
+
+    // Call f(counts) with the merged counts of every sub-multiset of at least two numbers.
+    // The multiset of all numbers is not part of any other, so it only needs the counts
+    // of the values in last, which saves most of the work if that is narrow.
+    template <typename F>
+    void forEachMultiset(std::vector<int> const &numbers, int const limit, Window const last,
+                         F &&f)
+    {
+        assert(std::size(numbers) < 31);
+        assert(limit <= maxLimit);
+
+        // distinct numbers and how often they occur
+        std::vector<int> sorted(numbers);
+        std::sort(std::begin(sorted), std::end(sorted));
+        std::vector<int> distinct;
+        std::vector<unsigned> multiplicity;
+        for (int const n : sorted) {
+            if (not std::empty(distinct) and distinct.back() == n) ++multiplicity.back();
+            else {
+                distinct.push_back(n);
+                multiplicity.push_back(1);
+            }
+        }
+
+        // A sub-multiset is a number in a mixed radix system, digit k says how many copies
+        // of distinct[k] it holds. Removing copies makes the number smaller, so all parts
+        // of a multiset come before it in the order of their numbers.
+        std::vector<std::size_t> radix(std::size(distinct));
+        std::size_t nmultisets = 1;
+        for (std::size_t k = 0; k < std::size(distinct); ++k) {
+            radix[k] = nmultisets;
+            nmultisets *= multiplicity[k] + 1;
+        }
+
+        std::vector<ValueCounts> counts(nmultisets);
+        std::vector<unsigned> sizes(nmultisets, 0);
+        for (std::size_t set = 1; set < nmultisets; ++set) {
+            // the size grows by one per digit, carries reset digits to zero
+            std::size_t k = 0;
+            while ((set / radix[k]) % (multiplicity[k] + 1) == 0) ++k;
+            sizes[set] = sizes[set - radix[k]] + 1;
+        }
+        for (std::size_t k = 0; k < std::size(distinct); ++k) {
+            if (distinct[k] > 0 and distinct[k] <= limit) {
+                counts[radix[k]].emplace_back(distinct[k], 1);
+            }
+        }
+
+        std::vector<unsigned> digits(std::size(distinct)), part(std::size(distinct));
+        for (std::size_t set = 1; set < nmultisets; ++set) {
+            if (sizes[set] < 2) continue;
+            Window const window = set == nmultisets - 1 ? last : Window{0, limit};
+            for (std::size_t k = 0; k < std::size(distinct); ++k) {
+                digits[k] = static_cast<unsigned>((set / radix[k]) % (multiplicity[k] + 1));
+            }
+
+            // every ordered split into two non-empty parts, counting up part <= digits
+            auto &results = counts[set];
+            std::fill(std::begin(part), std::end(part), 0u);
+            for (std::size_t first = 0;;) {
+                // next part
+                std::size_t k = 0;
+                while (k < std::size(part) and part[k] == digits[k]) {
+                    first -= part[k] * radix[k];
+                    part[k++] = 0;
+                }
+                if (k == std::size(part)) break;
+                ++part[k];
+                first += radix[k];
+
+                if (first != set) {
+                    combineCounts(counts[first], counts[set - first], window, results);
+                }
+            }
+
+            merge(results);
+            f(std::as_const(results));
+        }
+    }
+}
+
+ValueCounts solutionCounts(std::vector<int> const &numbers, int const limit)
+{
+    return solutionCounts(numbers, 0, limit, limit);
+}
+
+ValueCounts solutionCounts(std::vector<int> const &numbers, int const lowest,
+                           int const highest, int const limit)
+{
+    Window const window{lowest, std::min(highest, limit)};
+    ValueCounts all;
+    forEachMultiset(numbers, limit, window, [&](ValueCounts const &counts) {
+        auto const byValue = [](auto const &l, auto const &r) { return l.first < r.first; };
+        auto const first = std::lower_bound(std::begin(counts), std::end(counts),
+                                            std::pair{window.lowest, std::uint64_t{0}}, byValue);
+        auto const last = std::upper_bound(first, std::end(counts),
+                                           std::pair{window.highest, std::uint64_t{0}}, byValue);
+        all.insert(std::end(all), first, last);
+    });
+    merge(all);
+    return all;
+}
+
+std::uint64_t countSolutions(std::vector<int> const &numbers, int const target,
+                             int const limit)
+{
+    std::uint64_t total = 0;
+    forEachMultiset(numbers, limit, Window{target, target}, [&](ValueCounts const &counts) {
+        auto const it = std::lower_bound(std::begin(counts), std::end(counts), target,
+                                         [](auto const &count, int const value) {
+                                             return count.first < value;
+                                         });
+        if (it != std::end(counts) and it->first == target) total += it->second;
+    });
+    return total;
+}
+
+}  // namespace countdown
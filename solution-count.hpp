@@ -0,0 +1,47 @@
+/*
+ * Count distinct solutions without building them.
+ *
+ * Two solutions are the same if they are the same tree of operations on the same
+ * values, which is exactly when their strings are the same. Such a tree uses a
+ * sub-multiset of the input numbers, so instead of subsets of positions (which would
+ * count trees with equal numbers swapped twice) the DP runs over sub-multisets.
+ * For every sub-multiset it keeps how many distinct trees make each value. A tree is
+ * an operation on the trees of two parts that split the multiset, with the larger
+ * value first, so the counts of a multiset are sums of products of the counts of its
+ * parts. Nothing is ever built, only counted.
+ */
+
+#ifndef COUNTDOWN_SOLUTION_COUNT_HPP
+#define COUNTDOWN_SOLUTION_COUNT_HPP
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "combine.hpp"
+
+namespace countdown {
+
+// (value, number of distinct expressions), sorted by value
+using ValueCounts = std::vector<std::pair<int, std::uint64_t>>;
+
+// The number of distinct expressions with at least one operation for every value that
+// can be made from numbers (at most 30).
+// Intermediate results larger than limit are dropped like in subsetValues.
+// Counts are exact as long as they fit into 64 bits, which holds for every draw of up
+// to 13 numbers.
+ValueCounts solutionCounts(std::vector<int> const &numbers, int limit = maxLimit);
+
+// Like above but only the values from lowest to highest, both inclusive.
+// Much faster if that is a narrow range, e.g. the targets of the show.
+ValueCounts solutionCounts(std::vector<int> const &numbers, int lowest, int highest,
+                           int limit = maxLimit);
+
+// The number of distinct solutions for target, i.e. what the tree search finds after
+// removing duplicates, without making a single expression.
+std::uint64_t countSolutions(std::vector<int> const &numbers, int target,
+                             int limit = maxLimit);
+
+}  // namespace countdown
+
+#endif  // COUNTDOWN_SOLUTION_COUNT_HPP
@@ -0,0 +1,178 @@
+#include "solution-format.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+namespace countdown {
+
+namespace {
+    // longest text of a record: 15 numbers of up to 11 characters and 14 operations
+    // of 5 characters ("(", " + ", ")"), plus the JSON around it
+    constexpr std::size_t maxLineSize = 512;
+
+    // returns the depth of node
+    int pack(raw::Node &node, SolutionRecord &record)
+    {
+        if (node.kind == raw::Node::Kind::val) {
+            if (record.size == SolutionRecord::maxTokens) {
+                throw std::length_error("expression too long for a solution record");
+            }
+            record.postfix[record.size++] = node.eval();
+            return 0;
+        }
+
+        int const depth = std::max(pack(*node.a(), record), pack(*node.b(), record)) + 1;
+        if (record.size == SolutionRecord::maxTokens) {
+            throw std::length_error("expression too long for a solution record");
+        }
+        switch (node.kind) {
+        case raw::Node::Kind::sum:
+            record.postfix[record.size++] = postfixSum;
+            break;
+        case raw::Node::Kind::sub:
+            record.postfix[record.size++] = postfixSub;
+            break;
+        case raw::Node::Kind::mul:
+            record.postfix[record.size++] = postfixMul;
+            break;
+        case raw::Node::Kind::div:
+            record.postfix[record.size++] = postfixDiv;
+            break;
+        case raw::Node::Kind::pow:
+            record.postfix[record.size++] = postfixPow;
+            break;
+        case raw::Node::Kind::cat:
+            record.postfix[record.size++] = postfixCat;
+            break;
+        case raw::Node::Kind::val:
+            break;
+        }
+        ++record.operations;
+        return depth;
+    }
+
+    char symbol(std::int32_t const op)
+    {
+        switch (op) {
+        case postfixSum: return '+';
+        case postfixSub: return '-';
+        case postfixMul: return '*';
+        case postfixPow: return '^';
+        case postfixCat: return '|';
+        default: return '/';
+        }
+    }
+
+    // Writes the expression that ends at token i of postfix, first[j] is the index of
+    // the first token of the expression that ends at j.
+    char *render(SolutionRecord const &record, std::uint8_t const *first, int const i, char *out)
+    {
+        auto const token = record.postfix[i];
+        if (token > 0) {
+            return std::to_chars(out, out + 11, token).ptr;
+        }
+        *out++ = '(';
+        out = render(record, first, first[i-1]-1, out);
+        *out++ = ' ';
+        *out++ = symbol(token);
+        *out++ = ' ';
+        out = render(record, first, i-1, out);
+        *out++ = ')';
+        return out;
+    }
+
+    char *renderExpression(SolutionRecord const &record, char *out)
+    {
+        if (record.size == 0) return out;
+
+        std::uint8_t first[SolutionRecord::maxTokens];
+        std::uint8_t stack[SolutionRecord::maxTokens];
+        std::size_t top = 0;
+        for (std::uint8_t i = 0; i < record.size; ++i) {
+            if (record.postfix[i] > 0) {
+                first[i] = i;
+            }
+            else {
+                --top;  // second operand
+                first[i] = first[stack[--top]];
+            }
+            stack[top++] = i;
+        }
+        return render(record, first, record.size-1, out);
+    }
+
+    char *append(char *out, std::string_view const text)
+    {
+        std::memcpy(out, text.data(), std::size(text));
+        return out + std::size(text);
+    }
+}
+
+std::size_t SolutionRecordHash::operator()(SolutionRecord const &record) const noexcept
+{
+    // FNV-1a over the tokens in use, the other fields follow from them
+    std::size_t hash = 14695981039346656037ull;
+    for (std::size_t i = 0; i < record.size; ++i) {
+        hash ^= static_cast<std::uint32_t>(record.postfix[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+SolutionRecord toRecord(raw::Node &node)
+{
+    SolutionRecord record{};
+    record.value = node.eval();
+    record.depth = static_cast<std::uint8_t>(pack(node, record));
+    return record;
+}
+
+std::string to_string(SolutionRecord const &record)
+{
+    char buffer[maxLineSize];
+    return std::string(buffer, renderExpression(record, buffer));
+}
+
+SolutionWriter::SolutionWriter(BufferedWriter &out, Format const format)
+    : out_{out}, format_{format}
+{
+    if (format_ == Format::binary) {
+        SolutionFileHeader header{};
+        std::memcpy(header.magic, solutionMagic, sizeof(header.magic));
+        header.version = solutionVersion;
+        header.recordSize = sizeof(SolutionRecord);
+        header.byteOrder = 0x01020304;
+        out_.write({reinterpret_cast<char const*>(&header), sizeof(header)});
+    }
+}
+
+void SolutionWriter::write(SolutionRecord const &record)
+{
+    char *const begin = out_.reserve(maxLineSize);
+    char *out = begin;
+    switch (format_) {
+    case Format::text:
+        out = renderExpression(record, out);
+        *out++ = '\n';
+        break;
+    case Format::ndjson:
+        out = append(out, R"({"expression":")");
+        out = renderExpression(record, out);
+        out = append(out, R"(","value":)");
+        out = std::to_chars(out, out + 11, record.value).ptr;
+        out = append(out, R"(,"operations":)");
+        out = std::to_chars(out, out + 3, record.operations).ptr;
+        out = append(out, R"(,"depth":)");
+        out = std::to_chars(out, out + 3, record.depth).ptr;
+        out = append(out, "}\n");
+        break;
+    case Format::binary:
+        out = append(out, {reinterpret_cast<char const*>(&record), sizeof(record)});
+        break;
+    }
+    out_.commit(static_cast<std::size_t>(out - begin));
+}
+
+}  // namespace countdown
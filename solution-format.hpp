@@ -0,0 +1,108 @@
+/*
+ * Machine readable output of solutions.
+ *
+ * Every solution is first packed into a fixed-size SolutionRecord that stores the
+ * expression in postfix order. From there it is written as a line of text, as a line
+ * of NDJSON, or as the raw record.
+ *
+ * The binary format is a SolutionFileHeader followed by records, in native byte order,
+ * so a file can be memory-mapped and read as an array of SolutionRecord.
+ * There is no count in the header because solutions are written as they are found,
+ * the number of records is (file size - sizeof(SolutionFileHeader)) / recordSize.
+ */
+
+#ifndef COUNTDOWN_SOLUTION_FORMAT_HPP
+#define COUNTDOWN_SOLUTION_FORMAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "raw-engine.hpp"
+#include "writer.hpp"
+
+namespace countdown {
+
+enum class Format
+{
+    // the expression, one per line
+    text,
+    // {"expression":"(2 + 3)","value":5,"operations":1,"depth":1}, one per line
+    ndjson,
+    // SolutionFileHeader followed by SolutionRecords
+    binary,
+};
+
+// postfix codes of the operations, numbers are stored as themselves (always positive)
+enum PostfixOp : std::int32_t
+{
+    postfixSum = -1,
+    postfixSub = -2,
+    postfixMul = -3,
+    postfixDiv = -4,
+    postfixPow = -5,
+    postfixCat = -6,
+};
+
+struct SolutionRecord
+{
+    // numbers and operations in postfix order, enough for 15 numbers
+    constexpr static std::size_t maxTokens = 30;
+
+    std::int32_t value;
+    // number of operations
+    std::uint8_t operations;
+    // longest chain of operations from the top to a number, 0 for a plain number
+    std::uint8_t depth;
+    // entries of postfix in use, the rest are 0
+    std::uint8_t size;
+    std::uint8_t reserved;
+    std::int32_t postfix[maxTokens];
+
+    bool operator==(SolutionRecord const &) const = default;
+};
+
+static_assert(sizeof(SolutionRecord) == 128);
+
+struct SolutionRecordHash
+{
+    std::size_t operator()(SolutionRecord const &record) const noexcept;
+};
+
+struct SolutionFileHeader
+{
+    char magic[8];
+    std::uint16_t version;
+    std::uint16_t recordSize;
+    // 0x01020304 as written by the machine that made the file
+    std::uint32_t byteOrder;
+};
+
+static_assert(sizeof(SolutionFileHeader) == 16);
+
+constexpr char solutionMagic[8] = {'C', 'D', 'S', 'O', 'L', 'N', 'S', '\0'};
+constexpr std::uint16_t solutionVersion = 1;
+
+// Pack the expression under node, throws std::length_error if it has too many numbers.
+SolutionRecord toRecord(raw::Node &node);
+
+// the expression in the same form as raw::to_string
+std::string to_string(SolutionRecord const &record);
+
+// Writes records in one format. Records are formatted directly into the writer's buffer,
+// nothing is allocated per solution.
+class SolutionWriter
+{
+    BufferedWriter &out_;
+    Format format_;
+
+public:
+    // writes the file header for the binary format
+    SolutionWriter(BufferedWriter &out, Format format);
+
+    void write(SolutionRecord const &record);
+};
+
+}  // namespace countdown
+
+#endif  // COUNTDOWN_SOLUTION_FORMAT_HPP
@@ -0,0 +1,85 @@
+#include "subset-dp.hpp"
+#include "combine.hpp"
+#include "subset-levels.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+
+namespace countdown {
+
+SubsetValues subsetValues(std::vector<int> const &numbers, int const limit,
+                          unsigned const threads)
+{
+    assert(std::size(numbers) < 31);
+    assert(limit <= maxLimit);
+
+    unsigned const nsubsets = 1u << std::size(numbers);
+    SubsetValues values(nsubsets);
+    for (std::size_t k = 0; k < std::size(numbers); ++k) {
+        if (numbers[k] > 0 and numbers[k] <= limit) {
+            values[1u << k].push_back(numbers[k]);
+        }
+    }
+
+    // one output buffer per thread, each subset is written by exactly one thread
+    std::vector<std::vector<int>> buffers(levelWorkers(threads));
+    forEachSubsetByLevel(
+        static_cast<unsigned>(std::size(numbers)), threads,
+        [&](unsigned const set, unsigned const worker) {
+            auto &results = buffers[worker];
+            results.clear();
+            // Split into two disjoint parts, each split only once:
+            // the first part always contains the lowest number in the set.
+            unsigned const lowest = set & -set;
+            for (unsigned part = (set-1) & set; part != 0; part = (part-1) & set) {
+                if (not (part & lowest)) continue;
+                combine(values[part], values[set ^ part], limit, results);
+            }
+
+            std::sort(std::begin(results), std::end(results));
+            results.erase(std::unique(std::begin(results), std::end(results)),
+                          std::end(results));
+            values[set] = results;
+        });
+
+    return values;
+}
+
+bool reachable(SubsetValues const &values, int const target)
+{
+    for (unsigned set = 1; set < std::size(values); ++set) {
+        if ((set & (set-1)) == 0) continue;  // single number
+        if (std::binary_search(std::cbegin(values[set]), std::cend(values[set]), target)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int nearest(SubsetValues const &values, int const target)
+{
+    int best = 0;
+    long bestDistance = std::numeric_limits<long>::max();
+    auto const consider = [&](int const value) {
+        long const distance = std::labs(static_cast<long>(value) - target);
+        if (distance < bestDistance or (distance == bestDistance and value < best)) {
+            best = value;
+            bestDistance = distance;
+        }
+    };
+
+    for (unsigned set = 1; set < std::size(values); ++set) {
+        if ((set & (set-1)) == 0) continue;  // single number
+        auto const &vals = values[set];
+        // only the neighbours of target in each sorted list can be closest
+        auto const it = std::lower_bound(std::cbegin(vals), std::cend(vals), target);
+        if (it != std::cend(vals)) consider(*it);
+        if (it != std::cbegin(vals)) consider(*std::prev(it));
+    }
+    return best;
+}
+
+}  // namespace countdown
@@ -0,0 +1,37 @@
+/*
+ * Dynamic programming over subsets of the input numbers.
+ *
+ * Instead of building trees of operations, compute the set of values that can be made
+ * from every subset of the inputs. The values of a subset are all combinations of the
+ * values of two disjoint subsets which together make up the whole subset.
+ * This only answers which numbers are reachable, not how.
+ */
+
+#ifndef COUNTDOWN_SUBSET_DP_HPP
+#define COUNTDOWN_SUBSET_DP_HPP
+
+#include <vector>
+
+namespace countdown {
+
+// Values which can be made from each subset of the input numbers.
+// Element i holds the sorted, distinct values that use exactly the numbers selected
+// by the bits of i, so element 0 is empty and element 1<<k only holds numbers[k].
+using SubsetValues = std::vector<std::vector<int>>;
+
+// Compute the values of all subsets of numbers (at most 30).
+// Intermediate results larger than limit are dropped.
+// Subsets of the same size are computed in parallel on the given number of threads,
+// 0 means all hardware threads.
+SubsetValues subsetValues(std::vector<int> const &numbers, int limit, unsigned threads = 1);
+
+// true if target can be made with at least one operation
+bool reachable(SubsetValues const &values, int target);
+
+// the value closest to target that can be made with at least one operation,
+// prefers the smaller one on ties, 0 if there is none
+int nearest(SubsetValues const &values, int target);
+
+}  // namespace countdown
+
+#endif  // COUNTDOWN_SUBSET_DP_HPP
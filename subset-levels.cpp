@@ -0,0 +1,104 @@
+#include "subset-levels.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace countdown {
+
+namespace {
+    // all subsets of n elements, grouped by their number of elements
+    std::vector<std::vector<unsigned>> subsetsByLevel(unsigned const n)
+    {
+        std::vector<std::vector<unsigned>> levels(n+1);
+        for (unsigned set = 1; set < (1u << n); ++set) {
+            levels[static_cast<std::size_t>(__builtin_popcount(set))].push_back(set);
+        }
+        return levels;
+    }
+
+    // Blocks until all threads have arrived, can be reused for the next level.
+    // The lock is only taken once per thread and level, never while combining.
+    class Barrier
+    {
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        unsigned const count_;
+        unsigned waiting_{0};
+        unsigned generation_{0};
+
+    public:
+        explicit Barrier(unsigned const count) noexcept
+            : count_{count}
+        { }
+
+        void arriveAndWait()
+        {
+            std::unique_lock lock{mutex_};
+            unsigned const generation = generation_;
+            if (++waiting_ == count_) {
+                waiting_ = 0;
+                ++generation_;
+                cv_.notify_all();
+            }
+            else {
+                cv_.wait(lock, [&] { return generation != generation_; });
+            }
+        }
+    };
+}
+
+unsigned levelWorkers(unsigned const threads) noexcept
+{
+    if (threads != 0) return threads;
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void forEachSubsetByLevel(unsigned const n, unsigned const threads,
+                          std::function<void(unsigned set, unsigned worker)> const &f)
+{
+    auto const levels = subsetsByLevel(n);
+    unsigned const workers = levelWorkers(threads);
+
+    if (workers == 1) {
+        for (unsigned k = 2; k <= n; ++k) {
+            for (unsigned const set : levels[k]) {
+                f(set, 0);
+            }
+        }
+        return;
+    }
+
+    // one cursor per level so that no thread has to reset it for the next one
+    auto const cursors = std::make_unique<std::atomic<std::size_t>[]>(n+1);
+    Barrier barrier{workers};
+
+    auto const work = [&](unsigned const worker) {
+        for (unsigned k = 2; k <= n; ++k) {
+            auto const &level = levels[k];
+            for (;;) {
+                std::size_t const i = cursors[k].fetch_add(1, std::memory_order_relaxed);
+                if (i >= std::size(level)) break;
+                f(level[i], worker);
+            }
+            // the next level reads what this one wrote
+            barrier.arriveAndWait();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned worker = 1; worker < workers; ++worker) {
+        pool.emplace_back(work, worker);
+    }
+    work(0);
+    for (auto &thread : pool) {
+        thread.join();
+    }
+}
+
+}  // namespace countdown
@@ -0,0 +1,29 @@
+/*
+ * Parallel driver for dynamic programming over subsets.
+ *
+ * A subset with k numbers only depends on subsets with fewer numbers.
+ * So all subsets with the same number of elements (popcount) can be computed at the
+ * same time once the previous level is done.
+ */
+
+#ifndef COUNTDOWN_SUBSET_LEVELS_HPP
+#define COUNTDOWN_SUBSET_LEVELS_HPP
+
+#include <functional>
+
+namespace countdown {
+
+// Call f(set, worker) for every subset of n elements that has at least two elements.
+// Goes through the subsets level by level, i.e. by increasing number of elements.
+// The subsets of one level are split between threads with a barrier between levels,
+// worker is in [0, threads) and identifies the calling thread for per-thread buffers.
+// threads == 0 means use all hardware threads.
+void forEachSubsetByLevel(unsigned n, unsigned threads,
+                          std::function<void(unsigned set, unsigned worker)> const &f);
+
+// the number of workers forEachSubsetByLevel uses for a requested number of threads
+unsigned levelWorkers(unsigned threads) noexcept;
+
+}  // namespace countdown
+
+#endif  // COUNTDOWN_SUBSET_LEVELS_HPP
@@ -0,0 +1,61 @@
+#include "top-k.hpp"
+
+#include <algorithm>
+
+namespace countdown::raw {
+
+int length(Node &node)
+{
+    if (node.kind == Node::Kind::val) {
+        int n = 1;
+        for (int value = node.eval(); value >= 10; value /= 10) ++n;
+        return n;
+    }
+    // "(a + b)"
+    return length(*node.a()) + length(*node.b()) + 5;
+}
+
+int depth(Node &node)
+{
+    if (node.kind == Node::Kind::val) return 0;
+    return std::max(depth(*node.a()), depth(*node.b())) + 1;
+}
+
+std::vector<ScoredSolution> topK(std::vector<Node*> const &startNodes, int const target,
+                                 std::size_t const k, Score const &score)
+{
+    // heap with the worst kept solution on top
+    auto const better = [](ScoredSolution const &l, ScoredSolution const &r) {
+        return l.score != r.score ? l.score < r.score : l.expression < r.expression;
+    };
+    std::vector<ScoredSolution> heap;
+    if (k == 0) return heap;
+    heap.reserve(k+1);
+
+    forEachSolution(startNodes, target, [&](Node &node) {
+        int const s = score(node);
+        // decide on the score alone if possible, only ties need the string
+        if (std::size(heap) == k and s > heap.front().score) return;
+
+        ScoredSolution solution{to_string(node), s};
+        if (std::size(heap) == k and not better(solution, heap.front())) return;
+        // a duplicate is either kept already or was worse than everything kept
+        if (std::any_of(std::begin(heap), std::end(heap), [&](ScoredSolution const &kept) {
+                return kept.expression == solution.expression;
+            })) {
+            return;
+        }
+
+        heap.push_back(std::move(solution));
+        std::push_heap(std::begin(heap), std::end(heap), better);
+        if (std::size(heap) > k) {
+            std::pop_heap(std::begin(heap), std::end(heap), better);
+            heap.pop_back();
+        }
+    });
+
+    std::sort_heap(std::begin(heap), std::end(heap), better);
+    return heap;
+}
+
+}  // namespace countdown::raw
@@ -0,0 +1,42 @@
+/*
+ * Keep only the best few solutions of a tree search.
+ *
+ * Solutions are scored when they are found and kept in a heap of fixed size with the
+ * worst on top. A solution that is not better than the worst one kept is dropped before
+ * its string is made, so the memory does not grow with the number of solutions.
+ */
+
+#ifndef COUNTDOWN_TOP_K_HPP
+#define COUNTDOWN_TOP_K_HPP
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "raw-engine.hpp"
+
+namespace countdown::raw {
+
+// lower is better
+using Score = std::function<int(Node &)>;
+
+// number of characters of to_string(node), without making the string
+int length(Node &node);
+
+// number of operations on the longest path from node to a number
+int depth(Node &node);
+
+struct ScoredSolution
+{
+    std::string expression;
+    int score;
+};
+
+// The k distinct solutions with the lowest score, best first, ties sorted by expression.
+std::vector<ScoredSolution> topK(std::vector<Node*> const &startNodes, int target,
+                                 std::size_t k, Score const &score = length);
+
+}  // namespace countdown::raw
+
+#endif  // COUNTDOWN_TOP_K_HPP
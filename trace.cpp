@@ -0,0 +1,128 @@
+#include "trace.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+namespace countdown::trace {
+
+namespace {
+    struct Event
+    {
+        char const *name;
+        // nanoseconds since start()
+        std::int64_t begin, end;
+    };
+
+    // events of one thread, only that thread appends to it
+    struct Buffer
+    {
+        std::vector<Event> events;
+        unsigned tid;
+        // set before the buffer is linked and never changed afterwards
+        Buffer *next{nullptr};
+    };
+
+    std::atomic<bool> on{false};
+    std::chrono::steady_clock::time_point origin;
+    // newest buffer
+    std::atomic<Buffer*> buffers{nullptr};
+    std::atomic<unsigned> nextTid{0};
+    // bumped by write() so that threads do not use buffers of an old trace
+    std::atomic<unsigned> generation{0};
+
+    thread_local Buffer *localBuffer = nullptr;
+    thread_local unsigned localGeneration = 0;
+
+    std::int64_t now() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - origin).count();
+    }
+
+    Buffer &buffer()
+    {
+        unsigned const current = generation.load(std::memory_order_acquire);
+        if (localBuffer == nullptr or localGeneration != current) {
+            auto buffer = new Buffer;
+            buffer->tid = nextTid.fetch_add(1, std::memory_order_relaxed);
+            buffer->events.reserve(1024);
+            buffer->next = buffers.load(std::memory_order_relaxed);
+            while (not buffers.compare_exchange_weak(buffer->next, buffer,
+                                                     std::memory_order_release,
+                                                     std::memory_order_relaxed)) { }
+            localBuffer = buffer;
+            localGeneration = current;
+        }
+        return *localBuffer;
+    }
+
+    // microseconds with all nanosecond digits, the unit of the trace format
+    void writeMicros(std::ostream &os, std::int64_t const ns)
+    {
+        auto const fraction = ns % 1000;
+        os << ns / 1000 << '.' << fraction / 100 << fraction / 10 % 10 << fraction % 10;
+    }
+}
+
+void start()
+{
+    origin = std::chrono::steady_clock::now();
+    on.store(true, std::memory_order_release);
+}
+
+bool enabled() noexcept
+{
+    return on.load(std::memory_order_acquire);
+}
+
+void write(std::ostream &os)
+{
+    on.store(false, std::memory_order_release);
+
+    os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    Buffer *buffer = buffers.exchange(nullptr, std::memory_order_acq_rel);
+    while (buffer != nullptr) {
+        os << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+           << buffer->tid << ",\"args\":{\"name\":\"thread " << buffer->tid << "\"}}";
+        first = false;
+        for (auto const &event : buffer->events) {
+            os << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+               << buffer->tid << ",\"ts\":";
+            writeMicros(os, event.begin);
+            os << ",\"dur\":";
+            writeMicros(os, event.end - event.begin);
+            os << '}';
+        }
+
+        Buffer *const next = buffer->next;
+        delete buffer;
+        buffer = next;
+    }
+    os << "\n]}\n";
+
+    nextTid.store(0, std::memory_order_relaxed);
+    generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+Scope::Scope(char const *const name) noexcept
+    : name_{enabled() ? name : nullptr}
+{
+    if (name_) begin_ = now();
+}
+
+Scope::~Scope()
+{
+    close();
+}
+
+void Scope::close()
+{
+    if (name_ == nullptr) return;
+    std::int64_t const end = now();
+    buffer().events.push_back({name_, begin_, end});
+    name_ = nullptr;
+}
+
+}  // namespace countdown::trace
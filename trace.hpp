@@ -0,0 +1,48 @@
+/*
+ * Record when the phases of a solve run on which thread.
+ *
+ * Tracing is off until start() is called, scopes then record one event each into a
+ * buffer owned by their thread. Buffers are linked into a list with an atomic swap when
+ * a thread records for the first time, so recording never takes a lock.
+ * write() produces Chrome trace JSON that can be opened in chrome://tracing or Perfetto.
+ */
+
+#ifndef COUNTDOWN_TRACE_HPP
+#define COUNTDOWN_TRACE_HPP
+
+#include <cstdint>
+#include <ostream>
+
+namespace countdown::trace {
+
+// Start recording, timestamps count from now.
+void start();
+
+// whether start() was called and write() not yet
+bool enabled() noexcept;
+
+// Stop recording and write all events as Chrome trace JSON.
+// No thread may be recording at the same time.
+void write(std::ostream &os);
+
+// Records an event from construction until close() or destruction.
+// name must outlive the trace, usually it is a literal.
+class Scope
+{
+    char const *name_;
+    std::int64_t begin_{0};
+
+public:
+    explicit Scope(char const *name) noexcept;
+    ~Scope();
+
+    Scope(Scope const &) = delete;
+    Scope &operator=(Scope const &) = delete;
+
+    // end the event early, the destructor does nothing afterwards
+    void close();
+};
+
+}  // namespace countdown::trace
+
+#endif  // COUNTDOWN_TRACE_HPP
@@ -0,0 +1,322 @@
+#include "value-bitset.hpp"
+#include "combine.hpp"
+#include "subset-levels.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define COUNTDOWN_HAVE_AVX2_KERNEL 1
+#include <immintrin.h>
+#else
+#define COUNTDOWN_HAVE_AVX2_KERNEL 0
+#endif
+
+namespace countdown {
+
+using Word = ValueBitset::Word;
+
+ValueBitset::ValueBitset(int const cap)
+    : cap_{cap}, words_((static_cast<std::size_t>(cap) + wordBits - 1) / wordBits, 0)
+{
+    assert(cap > 0);
+}
+
+namespace {
+    // Word-parallel building blocks, each dst[i] |= something of src for n words.
+
+    void orWordsScalar(Word *dst, Word const *src, std::size_t const n) noexcept
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            dst[i] |= src[i];
+        }
+    }
+
+    // dst |= src << shift, bits shifted past the end are dropped
+    void orShiftedUpScalar(Word *dst, Word const *src, std::size_t const n,
+                           std::size_t const shift) noexcept
+    {
+        std::size_t const ws = shift / ValueBitset::wordBits;
+        unsigned const bs = shift % ValueBitset::wordBits;
+        for (std::size_t i = ws; i < n; ++i) {
+            Word w = src[i-ws] << bs;
+            if (bs != 0 and i > ws) w |= src[i-ws-1] >> (ValueBitset::wordBits-bs);
+            dst[i] |= w;
+        }
+    }
+
+    // dst |= src >> shift, bits shifted below 0 are dropped
+    void orShiftedDownScalar(Word *dst, Word const *src, std::size_t const n,
+                             std::size_t const shift) noexcept
+    {
+        std::size_t const ws = shift / ValueBitset::wordBits;
+        unsigned const bs = shift % ValueBitset::wordBits;
+        for (std::size_t i = 0; i + ws < n; ++i) {
+            Word w = src[i+ws] >> bs;
+            if (bs != 0 and i+ws+1 < n) w |= src[i+ws+1] << (ValueBitset::wordBits-bs);
+            dst[i] |= w;
+        }
+    }
+
+#if COUNTDOWN_HAVE_AVX2_KERNEL
+
+    __attribute__((target("avx2")))
+    void orWordsAvx2(Word *dst, Word const *src, std::size_t const n) noexcept
+    {
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256i const d = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(dst+i));
+            __m256i const s = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src+i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst+i), _mm256_or_si256(d, s));
+        }
+        orWordsScalar(dst+i, src+i, n-i);
+    }
+
+    __attribute__((target("avx2")))
+    void orShiftedUpAvx2(Word *dst, Word const *src, std::size_t const n,
+                         std::size_t const shift) noexcept
+    {
+        std::size_t const ws = shift / ValueBitset::wordBits;
+        unsigned const bs = shift % ValueBitset::wordBits;
+        if (ws >= n) return;
+
+        // first word has no carry from below
+        dst[ws] |= src[0] << bs;
+        // shifting by 64 gives 0 in AVX2 which handles bs == 0 for the carry
+        __m128i const up = _mm_cvtsi32_si128(static_cast<int>(bs));
+        __m128i const down = _mm_cvtsi32_si128(static_cast<int>(ValueBitset::wordBits-bs));
+        std::size_t i = ws+1;
+        for (; i + 4 <= n; i += 4) {
+            __m256i const s = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src+i-ws));
+            __m256i const c = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src+i-ws-1));
+            __m256i const d = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(dst+i));
+            __m256i const w = _mm256_or_si256(_mm256_sll_epi64(s, up), _mm256_srl_epi64(c, down));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst+i), _mm256_or_si256(d, w));
+        }
+        for (; i < n; ++i) {
+            Word w = src[i-ws] << bs;
+            if (bs != 0) w |= src[i-ws-1] >> (ValueBitset::wordBits-bs);
+            dst[i] |= w;
+        }
+    }
+
+    __attribute__((target("avx2")))
+    void orShiftedDownAvx2(Word *dst, Word const *src, std::size_t const n,
+                           std::size_t const shift) noexcept
+    {
+        std::size_t const ws = shift / ValueBitset::wordBits;
+        unsigned const bs = shift % ValueBitset::wordBits;
+        if (ws >= n) return;
+
+        __m128i const down = _mm_cvtsi32_si128(static_cast<int>(bs));
+        __m128i const up = _mm_cvtsi32_si128(static_cast<int>(ValueBitset::wordBits-bs));
+        std::size_t i = 0;
+        // the last source word has no carry from above, leave it to the scalar loop
+        for (; i + ws + 5 <= n; i += 4) {
+            __m256i const s = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src+i+ws));
+            __m256i const c = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src+i+ws+1));
+            __m256i const d = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(dst+i));
+            __m256i const w = _mm256_or_si256(_mm256_srl_epi64(s, down), _mm256_sll_epi64(c, up));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst+i), _mm256_or_si256(d, w));
+        }
+        orShiftedDownScalar(dst+i, src+i, n-i, shift);
+    }
+
+#endif
+
+    using OrWordsFn = void(*)(Word*, Word const*, std::size_t);
+    using OrShiftedFn = void(*)(Word*, Word const*, std::size_t, std::size_t);
+
+    // the word kernels, picked once for the CPU we are running on
+    struct WordKernels
+    {
+        OrWordsFn orWords = orWordsScalar;
+        OrShiftedFn orShiftedUp = orShiftedUpScalar;
+        OrShiftedFn orShiftedDown = orShiftedDownScalar;
+
+        WordKernels() noexcept
+        {
+#if COUNTDOWN_HAVE_AVX2_KERNEL
+            if (haveAvx2()) {
+                orWords = orWordsAvx2;
+                orShiftedUp = orShiftedUpAvx2;
+                orShiftedDown = orShiftedDownAvx2;
+            }
+#endif
+        }
+    };
+
+    WordKernels const &kernels() noexcept
+    {
+        static WordKernels const k;
+        return k;
+    }
+
+    Word reverseBits(Word w) noexcept
+    {
+        w = ((w >> 1) & 0x5555555555555555ull) | ((w & 0x5555555555555555ull) << 1);
+        w = ((w >> 2) & 0x3333333333333333ull) | ((w & 0x3333333333333333ull) << 2);
+        w = ((w >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((w & 0x0F0F0F0F0F0F0F0Full) << 4);
+        return __builtin_bswap64(w);
+    }
+
+    // bit i of out is bit (n*64-1-i) of in
+    void reverse(std::vector<Word> const &in, std::vector<Word> &out)
+    {
+        out.resize(std::size(in));
+        std::transform(std::crbegin(in), std::crend(in), std::begin(out), reverseBits);
+    }
+
+    // Scratch space for combine, reused between subsets to avoid allocations.
+    struct Scratch
+    {
+        std::vector<Word> other;     // copy of the larger set that bits can be removed from
+        std::vector<Word> reversed;  // the larger set with bits reversed
+    };
+
+    // Add all results of combining a and b with +, -, *, / to result.
+    // Same rules as solve(): only pairs a > b and no remainders. Results >= cap are dropped.
+    void combine(ValueBitset const &a, ValueBitset const &b,
+                 ValueBitset &result, Scratch &scratch)
+    {
+        auto const &k = kernels();
+        int const cap = result.cap();
+
+        // shift by each value of the smaller set, the larger set is processed a word at a time
+        bool const aSmaller = a.count() < b.count();
+        ValueBitset const &small = aSmaller ? a : b;
+        ValueBitset const &large = aSmaller ? b : a;
+
+        std::size_t const n = std::size(large.words());
+        std::size_t const nbits = n*ValueBitset::wordBits;
+        Word *dst = result.words().data();
+        Word const *src = large.words().data();
+        scratch.other = large.words();
+        reverse(large.words(), scratch.reversed);
+
+        // scratch.other without bit c, pairs of equal numbers are never combined
+        auto const withoutBit = [&](int const c, auto &&f) {
+            bool const had = large.test(c);
+            if (had) scratch.other[c / ValueBitset::wordBits] &= ~(Word{1} << (c % ValueBitset::wordBits));
+            f(scratch.other.data());
+            if (had) scratch.other[c / ValueBitset::wordBits] |= Word{1} << (c % ValueBitset::wordBits);
+        };
+
+        // words past the largest value of the large set are empty and can be skipped
+        std::size_t used = n;
+        while (used > 0 and src[used-1] == 0) --used;
+
+        small.forEach([&](int const c) {
+            std::size_t const shift = static_cast<std::size_t>(c);
+            // x + c
+            withoutBit(c, [&](Word const *other) {
+                k.orShiftedUp(dst, other, std::min(n, used + shift/ValueBitset::wordBits + 1), shift);
+            });
+            // x - c for x > c, x == c ends up at 0 which is removed below
+            k.orShiftedDown(dst, src, used, shift);
+            // c - x for x < c
+            k.orShiftedDown(dst, scratch.reversed.data(), n, nbits-1-shift);
+
+            if (c == 1) {
+                // x * 1 and x / 1
+                withoutBit(c, [&](Word const *other) {
+                    k.orWords(dst, other, used);
+                });
+            }
+            else {
+                // x * c
+                int const maxFactor = (cap-1) / c;
+                for (std::size_t w = 0; w < n and static_cast<int>(w*ValueBitset::wordBits) <= maxFactor; ++w) {
+                    for (Word word = src[w]; word != 0; word &= word - 1) {
+                        int const x = static_cast<int>(w*ValueBitset::wordBits) + __builtin_ctzll(word);
+                        if (x > maxFactor) break;
+                        if (x != c) result.set(x * c);
+                    }
+                }
+                // x / c for multiples x of c
+                int const maxMultiple = std::min(cap-1, static_cast<int>(used*ValueBitset::wordBits));
+                for (int x = 2*c; x <= maxMultiple; x += c) {
+                    if (large.test(x)) result.set(x / c);
+                }
+            }
+
+            // c / x for divisors x < c
+            for (int x = 1; x*x <= c; ++x) {
+                if (c % x != 0) continue;
+                int const y = c / x;
+                if (x < c and large.test(x)) result.set(y);
+                if (y < c and y != x and large.test(y)) result.set(x);
+            }
+        });
+
+        // 0 is not allowed and the last word may have bits past the cap
+        result.reset(0);
+        if (cap % ValueBitset::wordBits != 0) {
+            result.words().back() &= (Word{1} << (cap % ValueBitset::wordBits)) - 1;
+        }
+    }
+}
+
+void ValueBitset::unite(ValueBitset const &other) noexcept
+{
+    assert(other.cap_ == cap_);
+    kernels().orWords(words_.data(), other.words_.data(), std::size(words_));
+}
+
+std::size_t ValueBitset::count() const noexcept
+{
+    std::size_t n = 0;
+    for (Word const w : words_) {
+        n += static_cast<std::size_t>(__builtin_popcountll(w));
+    }
+    return n;
+}
+
+SubsetBitsets subsetBitsets(std::vector<int> const &numbers, int const cap,
+                           unsigned const threads)
+{
+    assert(std::size(numbers) < 31);
+
+    unsigned const nsubsets = 1u << std::size(numbers);
+    SubsetBitsets bitsets(nsubsets, ValueBitset(cap));
+    for (std::size_t k = 0; k < std::size(numbers); ++k) {
+        if (numbers[k] > 0 and numbers[k] < cap) {
+            bitsets[1u << k].set(numbers[k]);
+        }
+    }
+
+    std::vector<Scratch> scratch(levelWorkers(threads));
+    forEachSubsetByLevel(
+        static_cast<unsigned>(std::size(numbers)), threads,
+        [&](unsigned const set, unsigned const worker) {
+            // each split only once: the first part always contains the lowest number in the set
+            unsigned const lowest = set & -set;
+            for (unsigned part = (set-1) & set; part != 0; part = (part-1) & set) {
+                if (not (part & lowest)) continue;
+                combine(bitsets[part], bitsets[set ^ part], bitsets[set], scratch[worker]);
+            }
+        });
+
+    return bitsets;
+}
+
+ValueBitset reachableSet(SubsetBitsets const &bitsets)
+{
+    ValueBitset all(bitsets.front().cap());
+    for (unsigned set = 1; set < std::size(bitsets); ++set) {
+        if ((set & (set-1)) == 0) continue;  // single number
+        all.unite(bitsets[set]);
+    }
+    return all;
+}
+
+bool reachable(SubsetBitsets const &bitsets, int const target)
+{
+    for (unsigned set = 1; set < std::size(bitsets); ++set) {
+        if ((set & (set-1)) == 0) continue;  // single number
+        if (bitsets[set].test(target)) return true;
+    }
+    return false;
+}
+
+}  // namespace countdown
@@ -0,0 +1,105 @@
+/*
+ * Reachable values as bitsets.
+ *
+ * For the question "can the target be reached" it is enough to know which values in a
+ * bounded range can be made from each subset of the inputs. Storing them as bits lets
+ * unions run over whole words and turns + and - with a fixed value into shifts.
+ * Values that do not fit below the cap are dropped, including intermediate results.
+ */
+
+#ifndef COUNTDOWN_VALUE_BITSET_HPP
+#define COUNTDOWN_VALUE_BITSET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace countdown {
+
+// A set of values in [0, cap).
+struct ValueBitset
+{
+    using Word = std::uint64_t;
+    constexpr static int wordBits = 64;
+
+private:
+    int cap_;
+    std::vector<Word> words_;
+
+public:
+    explicit ValueBitset(int cap);
+
+    int cap() const noexcept
+    {
+        return cap_;
+    }
+
+    bool test(int const value) const noexcept
+    {
+        return value >= 0 and value < cap_
+            and (words_[value / wordBits] >> (value % wordBits)) & 1u;
+    }
+
+    void set(int const value) noexcept
+    {
+        words_[value / wordBits] |= Word{1} << (value % wordBits);
+    }
+
+    void reset(int const value) noexcept
+    {
+        words_[value / wordBits] &= ~(Word{1} << (value % wordBits));
+    }
+
+    // add all values of other, which must have the same cap
+    void unite(ValueBitset const &other) noexcept;
+
+    // number of values in the set
+    std::size_t count() const noexcept;
+
+    // call f(value) for every value in increasing order
+    template <typename F>
+    void forEach(F &&f) const
+    {
+        for (std::size_t w = 0; w < std::size(words_); ++w) {
+            for (Word word = words_[w]; word != 0; word &= word - 1) {
+                f(static_cast<int>(w*wordBits) + __builtin_ctzll(word));
+            }
+        }
+    }
+
+    std::vector<Word> &words() noexcept
+    {
+        return words_;
+    }
+
+    std::vector<Word> const &words() const noexcept
+    {
+        return words_;
+    }
+};
+
+// Values in [0, cap) which can be made from each subset of the input numbers,
+// indexed like SubsetValues.
+using SubsetBitsets = std::vector<ValueBitset>;
+
+// the default cap, large enough for all targets of the TV show
+constexpr int defaultCap = 1 << 16;
+
+// the largest cap the library accepts, 512 KiB per subset or 32 MiB for six numbers
+constexpr int maxCap = 1 << 22;
+
+// Compute the reachable values of all subsets of numbers (at most 30).
+// Intermediate results at or above cap are dropped.
+// Subsets of the same size are computed in parallel, see subsetValues.
+SubsetBitsets subsetBitsets(std::vector<int> const &numbers, int cap = defaultCap,
+                            unsigned threads = 1);
+
+// all values which can be made with at least one operation
+ValueBitset reachableSet(SubsetBitsets const &bitsets);
+
+// true if target can be made with at least one operation, target must be below the cap
+bool reachable(SubsetBitsets const &bitsets, int target);
+
+}  // namespace countdown
+
+#endif  // COUNTDOWN_VALUE_BITSET_HPP
@@ -0,0 +1,67 @@
+#include "writer.hpp"
+
+#include <cstring>
+
+namespace countdown {
+
+BufferedWriter::BufferedWriter(std::ostream &out, std::chrono::milliseconds const interval,
+                               std::size_t const capacity)
+    : out_{out}, buffer_(capacity), interval_{interval}
+{ }
+
+BufferedWriter::~BufferedWriter()
+{
+    flush();
+}
+
+void BufferedWriter::write(std::string_view const data)
+{
+    if (size_ + std::size(data) > std::size(buffer_)) {
+        flush();
+    }
+    if (std::size(data) > std::size(buffer_)) {
+        // does not fit at all, bypass the buffer
+        out_.write(data.data(), static_cast<std::streamsize>(std::size(data)));
+    }
+    else {
+        std::memcpy(buffer_.data() + size_, data.data(), std::size(data));
+        size_ += std::size(data);
+    }
+
+    flushIfDue();
+}
+
+char *BufferedWriter::reserve(std::size_t const n)
+{
+    if (size_ + n > std::size(buffer_)) {
+        flush();
+    }
+    if (n > std::size(buffer_)) {
+        buffer_.resize(n);
+    }
+    return buffer_.data() + size_;
+}
+
+void BufferedWriter::commit(std::size_t const n)
+{
+    size_ += n;
+    flushIfDue();
+}
+
+void BufferedWriter::flushIfDue()
+{
+    // the first write goes out immediately because lastFlush_ is in the distant past
+    if (size_ > 0 and std::chrono::steady_clock::now() - lastFlush_ >= interval_) {
+        flush();
+    }
+}
+
+void BufferedWriter::flush()
+{
+    out_.write(buffer_.data(), static_cast<std::streamsize>(size_));
+    out_.flush();
+    size_ = 0;
+    lastFlush_ = std::chrono::steady_clock::now();
+}
+
+}  // namespace countdown
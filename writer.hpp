@@ -0,0 +1,60 @@
+/*
+ * Buffered output for streaming results.
+ *
+ * Collects output in a buffer that is reused for the whole run and writes it out when it
+ * is full or when the flush interval has passed since the last write, so consumers
+ * get results soon after they are found without a system call per line.
+ * The interval is only checked on writes and on flushIfDue(), there is no timer: a
+ * producer that can go quiet for long calls flushIfDue() while it waits, or data
+ * written just after a flush stays in the buffer until the next write.
+ */
+
+#ifndef COUNTDOWN_WRITER_HPP
+#define COUNTDOWN_WRITER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace countdown {
+
+class BufferedWriter
+{
+    std::ostream &out_;
+    std::vector<char> buffer_;
+    std::size_t size_{0};
+    std::chrono::steady_clock::duration interval_;
+    std::chrono::steady_clock::time_point lastFlush_{};
+
+public:
+    // an interval of 0 flushes after every write
+    explicit BufferedWriter(std::ostream &out,
+                            std::chrono::milliseconds interval = std::chrono::milliseconds{100},
+                            std::size_t capacity = 1 << 16);
+
+    BufferedWriter(BufferedWriter const &) = delete;
+    BufferedWriter &operator=(BufferedWriter const &) = delete;
+
+    ~BufferedWriter();
+
+    // Append data, writes the buffer out if it is full or the interval has passed.
+    void write(std::string_view data);
+
+    // write out everything buffered so far
+    void flush();
+
+    // flush() if something is buffered and the interval has passed since the last flush
+    void flushIfDue();
+
+    // Space for n bytes at the end of the buffer to be filled in place, so that callers
+    // can format records without temporary strings. Follow with commit() of the number
+    // of bytes actually used, which may be less than n.
+    char *reserve(std::size_t n);
+    void commit(std::size_t n);
+};
+
+}  // namespace countdown
+
+#endif  // COUNTDOWN_WRITER_HPP